@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#include <bench.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace benchmark {
+
+static std::vector<Benchmark *> &
+registry() {
+    static std::vector<Benchmark *> benchmarks;
+    return benchmarks;
+}
+
+Benchmark *
+RegisterBenchmark(const char *name, Function fn) {
+    Benchmark *b = new Benchmark(name, fn);
+    registry().push_back(b);
+    return b;
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double ns;
+    std::map<std::string, double> counters;
+};
+
+static Result
+run(const Benchmark &b, bool has_arg, int64_t arg, double min_time) {
+    std::string name = b.name();
+    if (has_arg) name += "/" + std::to_string(arg);
+
+    uint64_t iterations = 1;
+    for (;;) {
+        State state(iterations, arg);
+        b.fn()(state);
+        double ns = state.elapsed_ns();
+
+        if ((ns >= min_time * 1e9) || (iterations >= (1ull << 40))) {
+            Result r = {name, iterations, ns / static_cast<double>(iterations), state.counters};
+            if ((state.items_processed() != 0) && (ns > 0))
+                r.counters["items_per_second"] = static_cast<double>(state.items_processed()) * 1e9 / ns;
+            return r;
+        }
+
+        // aim past min_time, grow at most tenfold per round
+        double scale = (ns > 0) ? (min_time * 1.4e9 / ns) : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        if (scale < 2.0) scale = 2.0;
+        iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+    }
+}
+
+static void
+write_json(const char *file, const std::vector<Result> &results) {
+    FILE *f = fopen(file, "w");
+    if (f == nullptr) {
+        perror(file);
+        return;
+    }
+
+    fprintf(f, "{\n  \"context\": {\"library\": \"imx8mq host bench\"},\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(f,
+                "    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %llu, "
+                "\"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"ns\"",
+                r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns, r.ns);
+        for (auto &c : r.counters)
+            fprintf(f, ", \"%s\": %.3f", c.first.c_str(), c.second);
+        fprintf(f, "}%s\n", (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+/* --filter=SUBSTR, --min_time=SECONDS, --json=FILE */
+int
+RunSpecifiedBenchmarks(int argc, char **argv) {
+    const char *filter = nullptr;
+    const char *json = nullptr;
+    double min_time = 0.2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else if (strncmp(argv[i], "--min_time=", 11) == 0)
+            min_time = atof(argv[i] + 11);
+        else if (strncmp(argv[i], "--json=", 7) == 0)
+            json = argv[i] + 7;
+        else {
+            fprintf(stderr, "usage: %s [--filter=SUBSTR] [--min_time=SECONDS] [--json=FILE]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    printf("%-40s %14s %14s  %s\n", "Benchmark", "Time (ns)", "Iterations", "Counters");
+    for (Benchmark *b : registry()) {
+        if ((filter != nullptr) && (b->name().find(filter) == std::string::npos)) continue;
+
+        std::vector<int64_t> args = b->args();
+        bool has_arg = !args.empty();
+        if (!has_arg) args.push_back(0);
+
+        for (int64_t arg : args) {
+            Result r = run(*b, has_arg, arg, min_time);
+            printf("%-40s %14.1f %14llu ", r.name.c_str(), r.ns,
+                   static_cast<unsigned long long>(r.iterations));
+            for (auto &c : r.counters)
+                printf(" %s=%.3g", c.first.c_str(), c.second);
+            printf("\n");
+            results.push_back(r);
+        }
+    }
+
+    if (json != nullptr) write_json(json, results);
+    return 0;
+}
+
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/**
+ * Minimal benchmark harness with the interface of Google Benchmark, so that the suite can
+ * move to the real library unchanged. Each benchmark runs until it took at least
+ * min_time, results are printed as a table and optionally written as Google Benchmark
+ * JSON (--json=FILE) for tracking with its compare tools.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+class State {
+public:
+    State(uint64_t iterations, int64_t arg) : _iterations(iterations), _arg(arg) {}
+
+    // the clock stops when the loop reaches end(), what follows the loop is not measured
+    struct Iterator {
+        State *state;
+        uint64_t left;
+        bool operator!=(const Iterator &) const {
+            if (left != 0) return true;
+            state->stop();
+            return false;
+        }
+        void operator++() { left--; }
+        struct __attribute__((unused)) Value {};
+        Value operator*() const { return Value(); }
+    };
+
+    Iterator begin() {
+        _start = std::chrono::steady_clock::now();
+        return Iterator{this, _iterations};
+    }
+
+    Iterator end() {
+        return Iterator{this, 0};
+    }
+
+    uint64_t iterations() const { return _iterations; }
+    int64_t range(int) const { return _arg; }
+
+    // excluded from the measured time
+    void PauseTiming() { _paused_at = std::chrono::steady_clock::now(); }
+    void ResumeTiming() { _paused += std::chrono::steady_clock::now() - _paused_at; }
+
+    double elapsed_ns() const {
+        auto t = (_stopped ? _stop : std::chrono::steady_clock::now()) - _start - _paused;
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+    }
+
+    // reported as items_per_second over the measured time
+    void SetItemsProcessed(int64_t items) { _items = items; }
+    int64_t items_processed() const { return _items; }
+
+    std::map<std::string, double> counters;
+
+private:
+    void stop() {
+        _stop = std::chrono::steady_clock::now();
+        _stopped = true;
+    }
+
+    int64_t _items = 0;
+    bool _stopped = false;
+    uint64_t _iterations;
+    int64_t _arg;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _stop;
+    std::chrono::steady_clock::time_point _paused_at;
+    std::chrono::steady_clock::duration _paused{};
+};
+
+typedef void (*Function)(State &);
+
+class Benchmark {
+public:
+    Benchmark(const char *name, Function fn) : _name(name), _fn(fn) {}
+
+    Benchmark *Arg(int64_t arg) {
+        _args.push_back(arg);
+        return this;
+    }
+
+    const std::string &name() const { return _name; }
+    Function fn() const { return _fn; }
+    const std::vector<int64_t> &args() const { return _args; }
+
+private:
+    std::string _name;
+    Function _fn;
+    std::vector<int64_t> _args;
+};
+
+Benchmark *RegisterBenchmark(const char *name, Function fn);
+
+template <class T>
+inline void
+DoNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void
+ClobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+/* cycle count of the host, the TSC on x86 and the virtual count on aarch64 */
+inline uint64_t
+CycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t val;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(val)::"memory");
+    return val;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+int RunSpecifiedBenchmarks(int argc, char **argv);
+
+}
+
+#define BENCHMARK_CAT(a, b) a##b
+#define BENCHMARK_NAME(line) BENCHMARK_CAT(benchmark_reg_, line)
+#define BENCHMARK(fn)                                                                              \
+    static ::benchmark::Benchmark *BENCHMARK_NAME(__LINE__)                                        \
+        __attribute__((unused)) = ::benchmark::RegisterBenchmark(#fn, fn)
+
+#define BENCHMARK_MAIN()                                                                           \
+    int main(int argc, char **argv) { return ::benchmark::RunSpecifiedBenchmarks(argc, argv); }
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/**
+ * Microbenchmarks of the clock tree on the host, the register windows are simulated (see
+ * imxsim.hpp). Built once with and once without CLK_DEVIRT, both with CLK_DISPATCH_STATS,
+ * compare the two runs with make devirt or the Google Benchmark compare tools.
+ */
+
+// the driver headers go first, the std headers define errno as a macro
+#include <imx8mq.hpp>
+
+#include <atomic>
+#include <bench.hpp>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+static void
+reset_hw(void) {
+    imx_sim.reset();
+    imx_regs = Imx_regfile(CCM_VA, CCM_SIZE, ANATOP_VA, ANATOP_SIZE,
+                           CLK_CCM_ALIASES ? Imx_regfile::ALIASED0 : 0);
+}
+
+/* a controller over freshly reset registers, probed unless told otherwise */
+static Imx_ClkCtrl &
+fresh_ctrl(bool probe = true) {
+    alignas(Imx_ClkCtrl) static char storage[sizeof(Imx_ClkCtrl)];
+    reset_hw();
+    Imx_ClkCtrl *ctrl = new (storage) Imx_ClkCtrl();
+    if (probe) ctrl->probe();
+    return *ctrl;
+}
+
+static void
+mmio_counters(benchmark::State &state, const Imx_sim::Stats &start) {
+    Imx_sim::Stats now = imx_sim.stats();
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["mmio_reads"] = static_cast<double>(now.reads - start.reads) / iterations;
+    state.counters["mmio_writes"] = static_cast<double>(now.writes - start.writes) / iterations;
+}
+
+/* full probe of the tree over cold registers */
+static void
+BM_probe(benchmark::State &state) {
+    uint64 reads = 0, writes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Imx_ClkCtrl &ctrl = fresh_ctrl(false);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(ctrl.probe());
+
+        Imx_sim::Stats stats = imx_sim.stats(); // reset by fresh_ctrl
+        reads += stats.reads;
+        writes += stats.writes;
+    }
+    state.counters["mmio_reads"] = static_cast<double>(reads) / state.iterations();
+    state.counters["mmio_writes"] = static_cast<double>(writes) / state.iterations();
+}
+BENCHMARK(BM_probe);
+
+/* memoized rate of the UART1 root gate, five clocks below the oscillator */
+static void
+BM_get_rate_cached(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint64 rate;
+    for (auto _ : state) {
+        ctrl.get_clkrate(IMX8MQ_CLK_UART1_ROOT, rate);
+        benchmark::DoNotOptimize(rate);
+    }
+}
+BENCHMARK(BM_get_rate_cached);
+
+/**
+ * A rate after its chain was invalidated, every ancestor is computed again. range(0)
+ * picks the chain: 0 - UART1 root on the oscillator, 1 - SAI1 root on the audio PLL.
+ * dispatches and virtual_calls count the Clk_ops calls per query, cycles are those of the
+ * query itself, with the reads of the cycle counter.
+ */
+static void
+BM_get_rate_chain(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint64 id = IMX8MQ_CLK_UART1_ROOT;
+    if (state.range(0) == 1) {
+        ctrl.configure(IMX8MQ_CLK_SAI1, IMX8MQ_AUDIO_PLL1_OUT, 0, drv_ipc::CLK_CONFIG_PARENT);
+        id = IMX8MQ_CLK_SAI1_ROOT;
+    }
+
+    uint64 rate, cycles = 0;
+    Clk_ops::Dispatch_stats calls = Clk_ops::dispatch_stats;
+    Imx_sim::Stats start = imx_sim.stats();
+    for (auto _ : state) {
+        state.PauseTiming();
+        ctrl.drop_rates(IMX8MQ_CLK_25M);
+        state.ResumeTiming();
+
+        uint64 c = benchmark::CycleCount();
+        ctrl.get_clkrate(id, rate);
+        cycles += benchmark::CycleCount() - c;
+        benchmark::DoNotOptimize(rate);
+    }
+    mmio_counters(state, start);
+
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["dispatches"]
+        = static_cast<double>(Clk_ops::dispatch_stats.calls - calls.calls) / iterations;
+    state.counters["virtual_calls"]
+        = static_cast<double>(Clk_ops::dispatch_stats.virtual_calls - calls.virtual_calls)
+          / iterations;
+    state.counters["cycles"] = static_cast<double>(cycles) / iterations;
+}
+BENCHMARK(BM_get_rate_chain)->Arg(0)->Arg(1);
+
+/**
+ * Divider search of a CCM root clock and the register update, alternating two rates off
+ * the 25 MHz oscillator UART1 runs from at reset.
+ */
+static void
+BM_ccm_set_rate(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint64 rates[2] = {25000000, 12500000};
+    uint32 n = 0;
+    Imx_sim::Stats start = imx_sim.stats();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ctrl.set_clkrate(IMX8MQ_CLK_UART1, rates[n++ & 1]));
+    mmio_counters(state, start);
+}
+BENCHMARK(BM_ccm_set_rate);
+
+/**
+ * Parent search of SAI1 over its running candidates, alternating between the 44.1 and
+ * 48 kHz families so that every request moves it to the other audio PLL.
+ */
+static void
+BM_ccm_set_rate_any_parent(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    ctrl.set_clkrate(IMX8MQ_AUDIO_PLL1, 786432000);
+    ctrl.set_clkrate(IMX8MQ_AUDIO_PLL2, 722534400);
+    ctrl.enable_clk(IMX8MQ_AUDIO_PLL1_OUT);
+    ctrl.enable_clk(IMX8MQ_AUDIO_PLL2_OUT);
+    ctrl.enable_clk(IMX8MQ_CLK_SAI1);
+
+    uint64 rates[2] = {11289600, 12288000};
+    uint32 n = 0;
+    Imx_sim::Stats start = imx_sim.stats();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ctrl.set_clkrate(IMX8MQ_CLK_SAI1, rates[n++ & 1]));
+    mmio_counters(state, start);
+}
+BENCHMARK(BM_ccm_set_rate_any_parent);
+
+/**
+ * Frac PLL retune with range(0) us until the new dividers are acknowledged, the time
+ * includes the wait. The counter is status polls per retune.
+ */
+static void
+BM_pll_set_rate(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    imx_sim.set_latency(70, static_cast<uint32>(state.range(0)));
+    ctrl.enable_clk(IMX8MQ_AUDIO_PLL1);
+    ctrl.reset_stats();
+
+    uint64 rates[2] = {786432000, 722534400};
+    uint32 n = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ctrl.set_clkrate(IMX8MQ_AUDIO_PLL1, rates[n++ & 1]));
+
+    Pll_lock::Stats lock;
+    ctrl.lock_stats(IMX8MQ_AUDIO_PLL1, lock);
+    state.counters["polls"] = static_cast<double>(lock.polls) / state.iterations();
+    state.counters["timeouts"] = lock.timeouts;
+    imx_sim.set_latency(70, 10);
+}
+BENCHMARK(BM_pll_set_rate)->Arg(0)->Arg(10)->Arg(50);
+
+/* divider search of the SCCG VIDEO2 PLL for display rates, no register is written */
+static void
+BM_sccg_round_rate(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint64 rates[2] = {594000000, 148500000};
+    uint32 n = 0;
+    uint64 rounded;
+    for (auto _ : state) {
+        ctrl.round_clkrate(IMX8MQ_VIDEO2_PLL_OUT, rates[n++ & 1], rounded);
+        benchmark::DoNotOptimize(rounded);
+    }
+}
+BENCHMARK(BM_sccg_round_rate);
+
+/* rate and description of every clock, the way a CLK_DUMP client sees the tree */
+static void
+BM_tree_walk(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint32 max = ctrl.get_max_clkid();
+    for (auto _ : state) {
+        for (uint32 id = 0; id < max; id++) {
+            uint64 rate;
+            Pm::clk_desc desc;
+            ctrl.get_clkrate(id, rate);
+            ctrl.describe_clkrate(id, desc);
+            benchmark::DoNotOptimize(rate);
+            benchmark::DoNotOptimize(desc);
+        }
+    }
+    state.counters["clocks"] = max;
+}
+BENCHMARK(BM_tree_walk);
+
+/* as above, every rate computed again after an invalidation of the tree */
+static void
+BM_tree_walk_cold(benchmark::State &state) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint32 max = ctrl.get_max_clkid();
+    for (auto _ : state) {
+        state.PauseTiming();
+        ctrl.set_clkrate(IMX8MQ_CLK_25M, 25000000);
+        state.ResumeTiming();
+
+        for (uint32 id = 0; id < max; id++) {
+            uint64 rate;
+            ctrl.get_clkrate(id, rate);
+            benchmark::DoNotOptimize(rate);
+        }
+    }
+}
+BENCHMARK(BM_tree_walk_cold);
+
+/**
+ * Lock-free rate queries of range(0) readers while a writer keeps changing the clock.
+ * The time is per query of the measuring reader. items_per_second is the throughput of
+ * all readers together over the measured time, the counter the writer's changes per
+ * query of the measuring reader.
+ */
+static void
+BM_seqlock_readers(benchmark::State &state) {
+    alignas(Imx8mq) static char storage[sizeof(Imx8mq)];
+    Pll_lock::Pause_hook *hook = Pll_lock::pause_hook;
+    reset_hw();
+    Imx8mq *drv = new (storage) Imx8mq();
+    drv->probe(nullptr, "", "");
+
+    // one counter per other reader, on a cache line of its own
+    struct alignas(64) Queries {
+        std::atomic<uint64> n{0};
+    };
+    uint32 others = static_cast<uint32>(state.range(0) - 1);
+    std::unique_ptr<Queries[]> queries(new Queries[others + 1]);
+    auto total = [&] {
+        uint64 sum = 0;
+        for (uint32 i = 0; i < others; i++)
+            sum += queries[i].n.load(std::memory_order_relaxed);
+        return sum;
+    };
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64> changes(0);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&] {
+        uint64 n = 0;
+        while (!stop.load(std::memory_order_relaxed))
+            drv->set_clkrate(IMX8MQ_CLK_UART1, (n++ & 1) ? 12500000 : 25000000);
+        changes = n;
+    });
+    for (uint32 i = 0; i < others; i++)
+        threads.emplace_back([&, i] {
+            uint64 rate;
+            while (!stop.load(std::memory_order_relaxed)) {
+                drv->get_clkrate(IMX8MQ_CLK_UART1_ROOT, rate);
+                benchmark::DoNotOptimize(rate);
+                queries[i].n.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+    uint64 rate;
+    uint64 start = total();
+    for (auto _ : state) {
+        drv->get_clkrate(IMX8MQ_CLK_UART1_ROOT, rate);
+        benchmark::DoNotOptimize(rate);
+    }
+    uint64 done = total() - start;
+
+    stop = true;
+    for (std::thread &t : threads)
+        t.join();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() + done));
+    state.counters["changes"] =
+        static_cast<double>(changes.load()) / static_cast<double>(state.iterations());
+
+    // the single threaded benchmarks run the controller without the tree lock
+    Pll_lock::pause_hook = hook;
+}
+BENCHMARK(BM_seqlock_readers)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/**
+ * Behavior checks of the clock tree against the simulated registers (see imxsim.hpp),
+ * for what the benchmarks do not look at. Exits non-zero if any check fails.
+ */
+
+// the driver headers go first, the std headers define errno as a macro
+#include <imx8mq.hpp>
+#include <imxsim.hpp>
+
+#include <new>
+#include <stdio.h>
+
+static unsigned failures = 0;
+
+#define CHECK(cond)                                                                                \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #cond);          \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (0)
+
+/* a probed controller over freshly reset registers */
+static Imx_ClkCtrl &
+fresh_ctrl(void) {
+    alignas(Imx_ClkCtrl) static char storage[sizeof(Imx_ClkCtrl)];
+    imx_sim.reset();
+    imx_regs = Imx_regfile(CCM_VA, CCM_SIZE, ANATOP_VA, ANATOP_SIZE,
+                           CLK_CCM_ALIASES ? Imx_regfile::ALIASED0 : 0);
+    Imx_ClkCtrl *ctrl = new (storage) Imx_ClkCtrl();
+    ctrl->probe();
+    return *ctrl;
+}
+
+static bool
+watched(const uint64 *changed, uint16 id) {
+    return changed[id / 64] & (1ull << (id % 64));
+}
+
+/* a PLL retune reaches the CCM roots below it, in their rates and in notifications */
+static void
+check_pll_retune_notifies_children(void) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    CHECK(ctrl.configure(IMX8MQ_CLK_SAI1, IMX8MQ_AUDIO_PLL1_OUT, 0, drv_ipc::CLK_CONFIG_PARENT)
+          == Errno::ENONE);
+
+    uint16 ids[] = {IMX8MQ_CLK_SAI1, IMX8MQ_AUDIO_PLL1_OUT};
+    uint32 sub;
+    CHECK(ctrl.subscribe(ids, 2, 0, sub) == Errno::ENONE);
+
+    CHECK(ctrl.set_clkrate(IMX8MQ_AUDIO_PLL1, 786432000) == Errno::ENONE);
+
+    uint64 pll, sai;
+    CHECK(ctrl.get_clkrate(IMX8MQ_AUDIO_PLL1_OUT, pll) == Errno::ENONE);
+    CHECK(ctrl.get_clkrate(IMX8MQ_CLK_SAI1, sai) == Errno::ENONE);
+    CHECK(pll != 800000000);
+    CHECK(sai == pll);
+
+    Imx_ClkCtrl::Clk_state state;
+    CHECK(ctrl.read_state(IMX8MQ_CLK_SAI1, state) && (state.rate == sai));
+
+    uint64 changed[drv_ipc::CLK_ID_WORDS];
+    CHECK(ctrl.take_changes(sub, changed) == Errno::ENONE);
+    CHECK(watched(changed, IMX8MQ_AUDIO_PLL1_OUT));
+    CHECK(watched(changed, IMX8MQ_CLK_SAI1));
+}
+
+enum : uint32 {
+    GPU_PLL_CFG0 = Imx_sim::ANATOP_BASE + 0x18,
+    FRAC_PD = (1u << 19),
+    FRAC_CLKE = (1u << 21),
+};
+
+/* a gate found running holds a boot reference that a client can drop to gate it */
+static void
+check_boot_gate_can_be_disabled(void) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    CHECK(imx_sim.peek(GPU_PLL_CFG0) & FRAC_CLKE);
+
+    CHECK(ctrl.disable_clk(IMX8MQ_GPU_PLL_OUT) == Errno::ENONE);
+    CHECK(!(imx_sim.peek(GPU_PLL_CFG0) & FRAC_CLKE));
+    CHECK(!(imx_sim.peek(GPU_PLL_CFG0) & FRAC_PD)); // the PLL keeps its own boot reference
+    CHECK(ctrl.disable_clk(IMX8MQ_GPU_PLL_OUT) == Errno::EINVAL);
+}
+
+/* an enable and disable pair of a client leaves what ran at boot running */
+static void
+check_client_pair_keeps_boot_chain(void) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    CHECK(ctrl.enable_clk(IMX8MQ_GPU_PLL_OUT) == Errno::ENONE);
+    CHECK(ctrl.disable_clk(IMX8MQ_GPU_PLL_OUT) == Errno::ENONE);
+    CHECK(imx_sim.peek(GPU_PLL_CFG0) & FRAC_CLKE);
+    CHECK(!(imx_sim.peek(GPU_PLL_CFG0) & FRAC_PD));
+    CHECK(ctrl.is_enabled(IMX8MQ_GPU_PLL));
+}
+
+/* critical SCCG PLLs advertise no rate they would refuse to set */
+static void
+check_critical_sccg_round_rate(void) {
+    Imx_ClkCtrl &ctrl = fresh_ctrl();
+    uint64 rate, rounded;
+    CHECK(ctrl.get_clkrate(IMX8MQ_DRAM_PLL_OUT, rate) == Errno::ENONE);
+    CHECK(ctrl.round_clkrate(IMX8MQ_DRAM_PLL_OUT, 600000000, rounded) == Errno::ENONE);
+    CHECK(rounded == rate);
+    CHECK(ctrl.set_clkrate(IMX8MQ_DRAM_PLL_OUT, 600000000) == Errno::EBUSY);
+
+    CHECK(ctrl.round_clkrate(IMX8MQ_VIDEO2_PLL_OUT, 594000000, rounded) == Errno::ENONE);
+    CHECK(rounded == 594000000);
+    CHECK(ctrl.set_clkrate(IMX8MQ_VIDEO2_PLL_OUT, 25000000) == Errno::ENONE); // bypass
+    CHECK(ctrl.get_clkrate(IMX8MQ_VIDEO2_PLL_OUT, rate) == Errno::ENONE);
+    CHECK(rate == 25000000);
+}
+
+/* async results nobody collected yet are never given away to new requests */
+static void
+check_async_results_kept_until_collected(void) {
+    alignas(Imx8mq) static char storage[sizeof(Imx8mq)];
+    Pll_lock::Pause_hook *hook = Pll_lock::pause_hook;
+    imx_sim.reset();
+    imx_regs = Imx_regfile(CCM_VA, CCM_SIZE, ANATOP_VA, ANATOP_SIZE,
+                           CLK_CCM_ALIASES ? Imx_regfile::ALIASED0 : 0);
+    Imx8mq *drv = new (storage) Imx8mq();
+    CHECK(drv->probe(nullptr, "", "") == Errno::ENONE);
+
+    uint32 tickets[CLK_ASYNC_JOBS], ticket;
+    mword sem;
+    for (uint32 i = 0; i < CLK_ASYNC_JOBS; i++)
+        CHECK(drv->submit(drv_ipc::method::CLK_ENABLE, IMX8MQ_CLK_UART1_ROOT, 0, 0, tickets[i])
+              == Errno::EINPROGRESS);
+    while (drv->run_job(sem)) {
+    }
+
+    CHECK(drv->submit(drv_ipc::method::CLK_ENABLE, IMX8MQ_CLK_UART1_ROOT, 0, 0, ticket)
+          == Errno::EBUSY);
+    CHECK(drv->async_status(tickets[0]) == Errno::ENONE);
+    CHECK(drv->async_status(tickets[0]) == Errno::EINVAL);
+    CHECK(drv->submit(drv_ipc::method::CLK_ENABLE, IMX8MQ_CLK_UART1_ROOT, 0, 0, ticket)
+          == Errno::EINPROGRESS);
+    for (uint32 i = 1; i < CLK_ASYNC_JOBS; i++)
+        CHECK(drv->async_status(tickets[i]) == Errno::ENONE);
+
+    Pll_lock::pause_hook = hook;
+}
+
+int
+main(void) {
+    check_pll_retune_notifies_children();
+    check_boot_gate_can_be_disabled();
+    check_client_pair_keeps_boot_chain();
+    check_critical_sccg_round_rate();
+    check_async_results_kept_until_collected();
+
+    if (failures != 0) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
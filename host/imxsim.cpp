@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#include <imxsim.hpp>
+#include <pebble/pebble.hpp>
+
+#include <time.h>
+
+Imx_sim imx_sim;
+
+uint64
+Pbl::host_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64>(ts.tv_sec) * 1000000000ull + static_cast<uint64>(ts.tv_nsec);
+}
+
+namespace {
+
+/* CFG0 bits, see Frac_pll and Sccg_pll_clk */
+enum : uint32 {
+    FRAC_REFCLK_DIV_MASK = (0x3fu << 5),
+    FRAC_NEWDIV_ACK = (1u << 11),
+    FRAC_NEWDIV_VAL = (1u << 12),
+    FRAC_BYPASS = (1u << 14),
+    FRAC_REFCLK_MASK = (0x3u << 16),
+    FRAC_PD = (1u << 19),
+    FRAC_CLKE = (1u << 21),
+    SCCG_PD = (1u << 7),
+    SCCG_CLKE = (1u << 9),
+    PLL_LOCK = (1u << 31),
+};
+
+/* SYS PLL output gates, CLKE and the fixed dividers from 40/50M up to 800/1000M */
+constexpr uint32 SCCG_GATES = 0x02aaaa00u | SCCG_CLKE;
+
+enum : mword {
+    CCGR_BASE = 0x4000,
+    CCGR_END = 0x4000 + 192 * 0x10,
+    ROOT_BASE = 0x8000,
+    ROOT_IP = 0xa000, // IP roots are off at reset, core and bus roots on
+    ROOT_END = 0xc000,
+    ROOT_ENABLE = (1u << 28),
+};
+
+/* CFG0 offset, frac or SCCG, power-on CFG0/CFG1/CFG2 */
+struct Pll_reset {
+    mword off;
+    bool frac;
+    uint32 cfg[3];
+};
+
+/**
+ * The PLLs the boot ROM needs run at their usual rates off the 25 MHz reference, the
+ * others are powered down. Frac: 25 MHz / 5 * 8 * 40 / 2 = 800 MHz. SCCG: 25 MHz * 2 *
+ * (DIVF1 + 1), 800 or 1000 MHz.
+ */
+const Pll_reset pll_resets[] = {
+    {0x00, true, {FRAC_PD | (4u << 5), 39, 0}}, // AUDIO1
+    {0x08, true, {FRAC_PD | (4u << 5), 39, 0}}, // AUDIO2
+    {0x10, true, {FRAC_PD | (4u << 5), 39, 0}}, // VIDEO1
+    {0x18, true, {PLL_LOCK | FRAC_CLKE | (4u << 5), 39, 0}}, // GPU
+    {0x20, true, {PLL_LOCK | FRAC_CLKE | (4u << 5), 39, 0}}, // VPU
+    {0x28, true, {PLL_LOCK | FRAC_CLKE | (4u << 5), 39, 0}}, // ARM
+    {0x30, false, {PLL_LOCK | SCCG_GATES, 0, 15u << 13}},  // SYS1
+    {0x3c, false, {PLL_LOCK | SCCG_GATES, 0, 19u << 13}},  // SYS2
+    {0x48, false, {PLL_LOCK | SCCG_GATES, 0, 19u << 13}},  // SYS3
+    {0x54, false, {SCCG_PD, 0, 15u << 13}},                // VIDEO2
+    {0x60, false, {PLL_LOCK | SCCG_CLKE, 0, 15u << 13}},   // DRAM
+};
+
+static_assert(sizeof(pll_resets) / sizeof(pll_resets[0]) == 11, "one reset entry per PLL");
+
+}
+
+void
+Imx_sim::reset(void) {
+    Lock_guard guard(_lock);
+
+    for (uint32 &r : _anatop)
+        r = 0;
+    for (uint32 &r : _ccm)
+        r = 0;
+
+    for (uint8 i = 0; i < NUM_PLLS; i++) {
+        const Pll_reset &p = pll_resets[i];
+        _plls[i] = Pll{p.off, p.frac, 0, 0};
+        for (uint8 n = 0; n < (p.frac ? 2 : 3); n++)
+            _anatop[p.off / 4 + n] = p.cfg[n];
+    }
+
+    for (mword off = CCGR_BASE; off < CCGR_END; off += 0x10)
+        _ccm[off / 4] = 0x3;
+    for (mword off = ROOT_BASE; off < ROOT_IP; off += 0x80)
+        _ccm[off / 4] = ROOT_ENABLE;
+
+    _stats = Stats();
+}
+
+Imx_sim::Pll *
+Imx_sim::pll_of(mword off) {
+    for (Pll &pll : _plls)
+        if ((off >= pll.off) && (off < pll.off + (pll.frac ? 8 : 12))) return &pll;
+    return nullptr;
+}
+
+/* status bits come up once their time has come */
+void
+Imx_sim::update(Pll &pll, uint64 now) {
+    uint32 &cfg0 = _anatop[pll.off / 4];
+    if (cfg0 & (pll.frac ? FRAC_PD : SCCG_PD)) return;
+
+    if (now >= pll.lock_at) cfg0 |= PLL_LOCK;
+    if (pll.frac && (cfg0 & FRAC_NEWDIV_VAL) && (now >= pll.ack_at)) cfg0 |= FRAC_NEWDIV_ACK;
+}
+
+void
+Imx_sim::write_pll(Pll &pll, mword off, uint32 val, uint64 now) {
+    uint32 &r = _anatop[off / 4];
+
+    if (off != pll.off) { // CFG1, CFG2
+        if (!pll.frac && (off == pll.off + 8) && (val != r)) {
+            _anatop[pll.off / 4] &= ~PLL_LOCK; // new dividers, relock
+            pll.lock_at = now + _lock_ns;
+        }
+        r = val;
+        return;
+    }
+
+    const uint32 status = pll.frac ? (PLL_LOCK | FRAC_NEWDIV_ACK) : PLL_LOCK;
+    const uint32 pd = pll.frac ? FRAC_PD : SCCG_PD;
+    uint32 old = r;
+    r = (val & ~status) | (old & status);
+
+    if (r & pd) {
+        r &= ~status;
+        return;
+    }
+
+    bool relock = (old & pd) != 0;
+    if (pll.frac) relock |= ((old ^ r) & (FRAC_REFCLK_DIV_MASK | FRAC_REFCLK_MASK)) != 0;
+    if (relock) {
+        r &= ~PLL_LOCK;
+        pll.lock_at = now + _lock_ns;
+    }
+
+    if (pll.frac) {
+        if (!(r & FRAC_NEWDIV_VAL))
+            r &= ~FRAC_NEWDIV_ACK;
+        else if (!(old & FRAC_NEWDIV_VAL)) {
+            r &= ~FRAC_NEWDIV_ACK;
+            pll.ack_at = now + _ack_ns;
+        }
+    }
+}
+
+uint32
+Imx_sim::read(mword addr) {
+    Lock_guard guard(_lock);
+    _stats.reads++;
+
+    if ((addr >= ANATOP_BASE) && (addr < ANATOP_BASE + WINDOW_SIZE)) {
+        mword off = (addr - ANATOP_BASE) & ~mword(3);
+        Pll *pll = pll_of(off);
+        if (pll != nullptr) update(*pll, Pbl::host_ticks());
+        return _anatop[off / 4];
+    }
+    if ((addr >= CCM_BASE) && (addr < CCM_BASE + WINDOW_SIZE))
+        return _ccm[((addr - CCM_BASE) & ~mword(0xf)) / 4];
+
+    _stats.stray++;
+    return 0;
+}
+
+void
+Imx_sim::write(mword addr, uint32 val) {
+    Lock_guard guard(_lock);
+    _stats.writes++;
+
+    if ((addr >= ANATOP_BASE) && (addr < ANATOP_BASE + WINDOW_SIZE)) {
+        mword off = (addr - ANATOP_BASE) & ~mword(3);
+        Pll *pll = pll_of(off);
+        if (pll == nullptr) {
+            _anatop[off / 4] = val;
+            return;
+        }
+        uint64 now = Pbl::host_ticks();
+        update(*pll, now);
+        write_pll(*pll, off, val, now);
+        return;
+    }
+
+    if ((addr >= CCM_BASE) && (addr < CCM_BASE + WINDOW_SIZE)) {
+        mword off = addr - CCM_BASE;
+        uint32 &r = _ccm[(off & ~mword(0xf)) / 4];
+        switch (off & 0xc) {
+        case 0x0:
+            r = val;
+            return;
+        case 0x4:
+            r |= val;
+            break;
+        case 0x8:
+            r &= ~val;
+            break;
+        default:
+            r ^= val;
+            break;
+        }
+        _stats.alias_writes++;
+        return;
+    }
+
+    _stats.stray++;
+}
+
+uint32
+Imx_sim::peek(mword addr) {
+    Lock_guard guard(_lock);
+    if ((addr >= ANATOP_BASE) && (addr < ANATOP_BASE + WINDOW_SIZE))
+        return _anatop[((addr - ANATOP_BASE) & ~mword(3)) / 4];
+    if ((addr >= CCM_BASE) && (addr < CCM_BASE + WINDOW_SIZE))
+        return _ccm[((addr - CCM_BASE) & ~mword(0xf)) / 4];
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <pebble/types.hpp>
+#include <spinlock.hpp>
+
+/**
+ * Behavioral model of the i.MX8MQ CCM and ANATOP register windows behind ind/outd.
+ *
+ * CCM: every register has SET (+4), CLR (+8) and TOG (+0xc) aliases, reads of an alias
+ * return the register. Target roots and CCGRs come out of reset as the boot ROM leaves
+ * them, core and bus roots enabled, all gates on.
+ * ANATOP: the frac PLLs assert PLL_LOCK lock_us after they are powered up or their
+ * reference changes, and PLL_NEWDIV_ACK ack_us after PLL_NEWDIV_VAL is raised, until it is
+ * lowered again. The SCCG PLLs relock after power up and after a change of CFG2. Status
+ * bits are read-only. There are no aliases.
+ *
+ * Accesses are serialized, the driver lets other requests in while a PLL locks.
+ */
+class Imx_sim {
+public:
+    static constexpr mword ANATOP_BASE = 0x40000000;
+    static constexpr mword CCM_BASE = 0x40010000;
+    static constexpr mword WINDOW_SIZE = 0x10000;
+
+    struct Stats {
+        uint64 reads;
+        uint64 writes;
+        uint64 alias_writes; // through SET/CLR/TOG
+        uint64 stray;        // outside both windows
+    };
+
+    Imx_sim(void) { reset(); }
+
+    /* power-on state, statistics cleared, latencies kept */
+    void reset(void);
+
+    /* how long PLLs take to lock and to acknowledge new dividers */
+    void set_latency(uint32 lock_us, uint32 ack_us) {
+        Lock_guard guard(_lock);
+        _lock_ns = static_cast<uint64>(lock_us) * 1000;
+        _ack_ns = static_cast<uint64>(ack_us) * 1000;
+    }
+
+    uint32 read(mword addr);
+    void write(mword addr, uint32 val);
+
+    /* current value without side effects or statistics, e.g. to check the driver */
+    uint32 peek(mword addr);
+
+    Stats stats(void) {
+        Lock_guard guard(_lock);
+        return _stats;
+    }
+
+private:
+    static constexpr uint8 NUM_PLLS = 11;
+
+    struct Pll {
+        mword off; // of CFG0 in ANATOP
+        bool frac;
+        uint64 lock_at; // ns, when PLL_LOCK comes up if powered
+        uint64 ack_at;  // ns, when PLL_NEWDIV_ACK comes up if requested
+    };
+
+    Pll *pll_of(mword off);
+    void update(Pll &pll, uint64 now);
+    void write_pll(Pll &pll, mword off, uint32 val, uint64 now);
+
+    Spinlock _lock;
+    uint64 _lock_ns{70000};
+    uint64 _ack_ns{10000};
+    Stats _stats;
+    Pll _plls[NUM_PLLS];
+    uint32 _anatop[WINDOW_SIZE / 4];
+    uint32 _ccm[WINDOW_SIZE / 4];
+};
+
+extern Imx_sim imx_sim;
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/**
+ * Redundant register traffic of the clock tree, built with IMX_MMIO_TRACE. Runs a probe
+ * and a mix of requests over the simulated registers, then prints the STATS_MMIO report.
+ */
+
+// the driver headers go first, the std headers define errno as a macro
+#include <imx8mq.hpp>
+
+#include <stdio.h>
+
+static const char *const kind_names[CLK_KINDS] = {
+    "fixed", "fixdiv", "mux", "div", "gate", "frac_pll", "sccg_pll", "ccm",
+};
+
+static void
+workload(Imx8mq &drv) {
+    uint32 max = drv.get_max_clkid();
+    for (uint32 round = 0; round < 4; round++) {
+        for (uint32 id = 0; id < max; id++) {
+            uint64 rate;
+            Pm::clk_desc desc;
+            drv.get_clkrate(id, rate);
+            drv.describe_clkrate(id, desc);
+        }
+
+        drv.enable_clk(IMX8MQ_CLK_UART1_ROOT);
+        drv.set_clkrate(IMX8MQ_CLK_UART1, (round & 1) ? 12500000 : 25000000);
+        drv.disable_clk(IMX8MQ_CLK_UART1_ROOT);
+
+        drv.enable_clk(IMX8MQ_AUDIO_PLL1_OUT);
+        drv.set_clkrate(IMX8MQ_AUDIO_PLL1, (round & 1) ? 722534400 : 786432000);
+        drv.disable_clk(IMX8MQ_AUDIO_PLL1_OUT);
+    }
+}
+
+int
+main(void) {
+    static Imx8mq drv;
+    imx_sim.set_latency(5, 1);
+    if (drv.probe(nullptr, "", "") != Errno::ENONE) return 1;
+    workload(drv);
+
+    uint32 cursor = 0, num_recs = 0;
+    drv_ipc::mmio_stats_rec recs[CLK_KINDS];
+    if (drv.mmio_stats(cursor, recs, CLK_KINDS, num_recs) != Errno::ENONE) return 1;
+
+    uint64 traced = mmio_trace.recorded();
+    if (traced > MMIO_TRACE_ENTRIES)
+        printf("%llu accesses traced, the ring wrapped and the report covers the last %u\n\n",
+               static_cast<unsigned long long>(traced), MMIO_TRACE_ENTRIES);
+    else
+        printf("%llu accesses traced, the report covers all of them\n\n",
+               static_cast<unsigned long long>(traced));
+    printf("%-10s %8s %8s %8s %8s %10s %8s %8s\n", "kind", "reads", "hw", "writes", "hw",
+           "redundant", "known", "noop");
+    for (uint32 i = 0; i < num_recs; i++) {
+        const drv_ipc::mmio_stats_rec &r = recs[i];
+        printf("%-10s %8u %8u %8u %8u %10u %8u %8u\n", kind_names[r.kind], r.reads, r.hw_reads,
+               r.writes, r.hw_writes, r.redundant_reads, r.known_reads, r.noop_writes);
+    }
+    return 0;
+}
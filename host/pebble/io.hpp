@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/* host stand-in for the MMIO accessors, the CCM and ANATOP windows are simulated */
+
+#pragma once
+#include <imxsim.hpp>
+
+static inline uint32
+ind(mword addr) {
+    return imx_sim.read(addr);
+}
+
+static inline void
+outd(mword addr, uint32 val) {
+    imx_sim.write(addr, val);
+}
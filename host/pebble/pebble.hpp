@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/* host stand-in for pebble, resources are always there and there is nothing to schedule */
+
+#pragma once
+#include <pebble/types.hpp>
+
+namespace Pbl {
+
+struct Utcb {};
+
+/* monotonic nanoseconds, the generic timer of the host build */
+uint64 host_ticks(void);
+
+namespace API {
+
+enum Res_type { RES_REG };
+
+static inline Errno
+acquire_resource(Utcb *, const char *, Res_type, uint32, mword, uint32, bool) {
+    return Errno::ENONE;
+}
+
+}
+
+}
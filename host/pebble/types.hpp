@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+/* host stand-in for the pebble types, just what the clock driver uses */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef unsigned long mword;
+typedef mword Sel;
+typedef mword Cpu;
+typedef mword Mtd;
+
+#define __ALWAYS_INLINE__ __attribute__((always_inline))
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE (4096UL)
+#endif
+
+enum Errno {
+    ENONE = 0,
+    ETIMEOUT,
+    EABORT,
+    ESYS,
+    ECAP,
+    EMEM,
+    ENOTSUP,
+    EINVAL,
+    EPERM,
+    EBUSY,
+    ETIMEDOUT,
+    EINPROGRESS,
+    EOVERFLOW,
+};
+
+struct Uuid {
+    uint64 lo;
+    uint64 hi;
+};
@@ -6,5 +6,48 @@
 
 #define PBL_STACK_SIZE (0x1000)
 #define SRV_STACK_SIZE (0x4000)
+#define WORKER_STACK_SIZE (0x4000)
 
-#define PBL_HEAP_SIZE (SRV_STACK_SIZE)
+/* CPUs with a service EC of their own */
+#define SRV_CPUS (4)
+
+#define PBL_HEAP_SIZE (SRV_CPUS * SRV_STACK_SIZE + WORKER_STACK_SIZE)
+
+/* sync a clock with the hardware on first use instead of at boot, see warm_clks */
+#define CLK_LAZY_INIT (0)
+
+/* dispatch clock operations on the kind tag instead of virtual calls, see Clk_ops */
+#ifndef CLK_DEVIRT
+#define CLK_DEVIRT (1)
+#endif
+
+/* count the Clk_ops dispatches and their virtual calls per thread, for the host benchmarks */
+#ifndef CLK_DISPATCH_STATS
+#define CLK_DISPATCH_STATS (0)
+#endif
+
+/* gate and enable bits of the CCM are written through its SET/CLR aliases, see Imx_regfile */
+#ifndef CLK_CCM_ALIASES
+#define CLK_CCM_ALIASES (1)
+#endif
+
+/* CLOCK_CHANGE_RATE_PARENT: parents this many ppm off a rate count as exact, see best_parent */
+#ifndef CLK_PARENT_TOLERANCE_PPM
+#define CLK_PARENT_TOLERANCE_PPM (0)
+#endif
+
+/* budget for a PLL to report lock or a new divider, and the longest pause between polls */
+#define PLL_LOCK_TIMEOUT_US (10000)
+#define PLL_LOCK_BACKOFF_US (64)
+
+/* async CLK_ENABLE/CLK_SET_RATE requests queued or waiting to be collected */
+#define CLK_ASYNC_JOBS (16)
+
+/* clients registered for rate change notifications */
+#define CLK_SUBSCRIBERS (16)
+
+/* record the register accesses of the clocks for STATS_MMIO, see Mmio_trace */
+#ifndef IMX_MMIO_TRACE
+#define IMX_MMIO_TRACE (0)
+#endif
+#define MMIO_TRACE_ENTRIES (4096)
@@ -5,6 +5,7 @@
  */
 
 #pragma once
+#include <imx8mq-clock.h>
 #include <pm.hpp>
 
 namespace drv_ipc {
@@ -22,8 +23,31 @@ enum method {
     NODE_ENABLE,
     NODE_DISABLE,
     PINCTRL_HANDLE,
+    CLK_BATCH,
+    CLK_ROUND_RATE,
+    CLK_ASYNC_STATUS,
+    CLK_SUBSCRIBE,
+    CLK_UNSUBSCRIBE,
+    CLK_CHANGES,
+    CLK_DUMP,
+    STATS_GET,
+    STATS_RESET,
+    CLK_CONFIGURE,
 };
 
+static constexpr uint32 NUM_METHODS = CLK_CONFIGURE + 1;
+
+/* bitmaps over clock ids */
+static constexpr size_t CLK_ID_WORDS = (IMX8MQ_CLK_END + 63) / 64;
+
+/* request flags of CLK_ENABLE and CLK_SET_RATE */
+enum clk_flags : uint32 {
+    CLK_ASYNC = (1u << 0), // return EINPROGRESS and a ticket, signal sem on completion
+};
+
+/* the message area is the UTCB page the portal is called with */
+static constexpr size_t IPC_BUFFER_SIZE = PAGE_SIZE;
+
 struct header {
     method id;
     header() = delete;
@@ -42,8 +66,11 @@ struct ret {
 
 struct clk_enable_args : header {
     uint64 clk_id;
+    uint32 flags;
+    mword sem; // semaphore delegated by the client, signaled when an async request is done
 
-    clk_enable_args(uint64 _id) : header(CLK_ENABLE), clk_id(_id) {}
+    clk_enable_args(uint64 _id, uint32 _flags = 0, mword _sem = 0)
+        : header(CLK_ENABLE), clk_id(_id), flags(_flags), sem(_sem) {}
 
     __ALWAYS_INLINE__
     constexpr static inline size_t size() {
@@ -51,7 +78,15 @@ struct clk_enable_args : header {
     }
 };
 
-struct clk_enable_ret : ret {};
+/* ticket is valid if errno is EINPROGRESS */
+struct clk_enable_ret : ret {
+    uint32 ticket;
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_enable_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
 
 struct clk_disable_args : header {
     uint64 clk_id;
@@ -122,8 +157,11 @@ struct clk_get_rate_ret : ret {
 struct clk_set_rate_args : header {
     uint64 clk_id;
     uint64 rate;
+    uint32 flags;
+    mword sem; // see clk_enable_args
 
-    clk_set_rate_args(uint64 _id, uint64 _rate) : header(CLK_GET_RATE), clk_id(_id), rate(_rate) {}
+    clk_set_rate_args(uint64 _id, uint64 _rate, uint32 _flags = 0, mword _sem = 0)
+        : header(CLK_SET_RATE), clk_id(_id), rate(_rate), flags(_flags), sem(_sem) {}
 
     __ALWAYS_INLINE__
     constexpr static inline size_t size() {
@@ -131,7 +169,94 @@ struct clk_set_rate_args : header {
     }
 };
 
-struct clk_set_rate_ret : ret {};
+/* ticket is valid if errno is EINPROGRESS */
+struct clk_set_rate_ret : ret {
+    uint32 ticket;
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_set_rate_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+struct clk_async_status_args : header {
+    uint32 ticket;
+
+    clk_async_status_args(uint32 _ticket) : header(CLK_ASYNC_STATUS), ticket(_ticket) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_async_status_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/**
+ * errno is EINPROGRESS while the request runs, then its result. A result is reported once,
+ * the ticket is invalid (EINVAL) afterwards. Until then the request keeps its slot, CLK_ASYNC
+ * requests fail with EBUSY while none is free.
+ */
+struct clk_async_status_ret : ret {};
+
+struct clk_round_rate_args : header {
+    uint64 clk_id;
+    uint64 rate;
+
+    clk_round_rate_args(uint64 _id, uint64 _rate)
+        : header(CLK_ROUND_RATE), clk_id(_id), rate(_rate) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_round_rate_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* rate CLK_SET_RATE would achieve, nothing is committed */
+struct clk_round_rate_ret : ret {
+    uint64 rate;
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_round_rate_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* what CLK_CONFIGURE changes, everything else is kept */
+enum clk_config_flags : uint32 {
+    CLK_CONFIG_PARENT = (1u << 0),  // select parent_id
+    CLK_CONFIG_RATE = (1u << 1),    // dividers for rate, off the new parent
+    CLK_CONFIG_ENABLE = (1u << 2),  // take a reference, as CLK_ENABLE
+    CLK_CONFIG_DISABLE = (1u << 3), // drop a reference, as CLK_DISABLE
+};
+
+/**
+ * Parent, rate and gate of a CCM clock changed together with one write to its target
+ * root, instead of a write per CLK_SET_RATE, CLK_ENABLE and so on, each of which may
+ * leave a glitching intermediate setup behind. ENOTSUP for other clocks.
+ */
+struct clk_configure_args : header {
+    uint64 clk_id;
+    uint64 parent_id;
+    uint64 rate;
+    uint32 flags;
+
+    clk_configure_args(uint64 _id, uint32 _flags, uint64 _parent = 0, uint64 _rate = 0)
+        : header(CLK_CONFIGURE), clk_id(_id), parent_id(_parent), rate(_rate), flags(_flags) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_configure_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* rate of the clock after the change */
+struct clk_configure_ret : ret {
+    uint64 rate;
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_configure_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
 
 struct clk_describe_rate_args : header {
     uint64 clk_id;
@@ -211,4 +336,360 @@ struct pinctrl_ret_ipc : ret {
     /*Size must be explicit!*/
 };
 
+/**
+ * One sub-operation of a CLK_BATCH request. Supported ops are CLK_ENABLE, CLK_DISABLE,
+ * CLK_GET_RATE, CLK_SET_RATE, CLK_ROUND_RATE and CLK_IS_ENABLED. Results are written back
+ * in place: errno always, value holds the rate (CLK_GET_RATE, CLK_ROUND_RATE) or the
+ * enabled flag (CLK_IS_ENABLED).
+ */
+struct clk_batch_op {
+    method op;
+    Errno errno;
+    uint64 clk_id;
+    uint64 value;
+};
+
+struct clk_batch_args : header {
+    uint32 num_ops;
+    clk_batch_op ops[];
+
+    clk_batch_args(void) : header(CLK_BATCH), num_ops(0) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t max_ops() {
+        return (IPC_BUFFER_SIZE - sizeof(clk_batch_args)) / sizeof(clk_batch_op);
+    }
+
+    __ALWAYS_INLINE__
+    inline size_t size() const {
+        return (sizeof(clk_batch_args) + num_ops * sizeof(clk_batch_op) + sizeof(mword) - 1)
+               / sizeof(mword);
+    }
+};
+
+/* same layout as the request, ops are updated in place */
+struct clk_batch_ret : ret {
+    uint32 num_ops;
+    clk_batch_op ops[];
+
+    __ALWAYS_INLINE__
+    inline size_t size() const {
+        return (sizeof(clk_batch_ret) + num_ops * sizeof(clk_batch_op) + sizeof(mword) - 1)
+               / sizeof(mword);
+    }
+};
+
+/**
+ * Client side helper: packs sub-operations into the UTCB until it is full.
+ * Send size() words, then read the per-op results back with result().
+ */
+class clk_batch_builder {
+public:
+    clk_batch_builder(mword utcb) : _args(reinterpret_cast<clk_batch_args *>(utcb)) {
+        _args->id = CLK_BATCH;
+        _args->num_ops = 0;
+    }
+
+    bool add(method op, uint64 clk_id, uint64 value = 0) {
+        if (full()) return false;
+
+        clk_batch_op &o = _args->ops[_args->num_ops++];
+        o.op = op;
+        o.errno = ENONE;
+        o.clk_id = clk_id;
+        o.value = value;
+        return true;
+    }
+
+    bool enable(uint64 clk_id) { return add(CLK_ENABLE, clk_id); }
+
+    bool disable(uint64 clk_id) { return add(CLK_DISABLE, clk_id); }
+
+    bool get_rate(uint64 clk_id) { return add(CLK_GET_RATE, clk_id); }
+
+    bool set_rate(uint64 clk_id, uint64 rate) { return add(CLK_SET_RATE, clk_id, rate); }
+
+    bool round_rate(uint64 clk_id, uint64 rate) { return add(CLK_ROUND_RATE, clk_id, rate); }
+
+    bool is_enabled(uint64 clk_id) { return add(CLK_IS_ENABLED, clk_id); }
+
+    bool full() const { return _args->num_ops >= clk_batch_args::max_ops(); }
+
+    uint32 count() const { return _args->num_ops; }
+
+    size_t size() const { return _args->size(); }
+
+    /* valid after the call returned */
+    Errno error() const { return reinterpret_cast<const clk_batch_ret *>(_args)->errno; }
+
+    const clk_batch_op &result(uint32 idx) const {
+        return reinterpret_cast<const clk_batch_ret *>(_args)->ops[idx];
+    }
+
+private:
+    clk_batch_args *_args;
+};
+
+/**
+ * Register for rate change notifications of the listed clocks. sem is a semaphore delegated
+ * by the client, it is signaled once per request that changed the rate of any of them,
+ * whether directly or through an ancestor. CLK_CHANGES tells which ones changed.
+ */
+struct clk_subscribe_args : header {
+    mword sem;
+    uint32 num_ids;
+    uint16 ids[];
+
+    clk_subscribe_args(mword _sem) : header(CLK_SUBSCRIBE), sem(_sem), num_ids(0) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t max_ids() {
+        return (IPC_BUFFER_SIZE - sizeof(clk_subscribe_args)) / sizeof(uint16);
+    }
+
+    __ALWAYS_INLINE__
+    inline size_t size() const {
+        return (sizeof(clk_subscribe_args) + num_ids * sizeof(uint16) + sizeof(mword) - 1)
+               / sizeof(mword);
+    }
+};
+
+struct clk_subscribe_ret : ret {
+    uint32 sub_id;
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_subscribe_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+struct clk_unsubscribe_args : header {
+    uint32 sub_id;
+
+    clk_unsubscribe_args(uint32 _sub) : header(CLK_UNSUBSCRIBE), sub_id(_sub) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_unsubscribe_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+struct clk_unsubscribe_ret : ret {};
+
+struct clk_changes_args : header {
+    uint32 sub_id;
+
+    clk_changes_args(uint32 _sub) : header(CLK_CHANGES), sub_id(_sub) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_changes_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* bit n of changed is set if clock n changed rate since the last CLK_CHANGES, then cleared */
+struct clk_changes_ret : ret {
+    uint64 changed[CLK_ID_WORDS];
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_changes_ret) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+struct clk_dump_args : header {
+    uint32 cursor; // first clock id to report, 0 to start over
+
+    clk_dump_args(uint32 _cursor) : header(CLK_DUMP), cursor(_cursor) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(clk_dump_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* one clock, ids without a clock are skipped */
+struct clk_dump_rec {
+    enum : uint8 {
+        VALID = (1u << 0), // synced, a lazily initialized clock may not be yet
+        RATE = (1u << 1),
+        ENABLED = (1u << 2),
+    };
+
+    uint32 rate;
+    uint16 id;
+    uint16 parent; // clock id, clk_status_page::NO_PARENT if there is none
+    uint8 kind;    // implementation of the clock, Clk_kind of the driver
+    uint8 flags;
+    uint16 reserved;
+};
+
+/**
+ * As many records as fit the UTCB, in id order. Call again with cursor until it is
+ * get_max_clkid(), the tree fits a single call today.
+ */
+struct clk_dump_ret : ret {
+    uint32 cursor; // next id to ask for
+    uint32 num_recs;
+    clk_dump_rec recs[];
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t max_recs() {
+        return (IPC_BUFFER_SIZE - sizeof(clk_dump_ret)) / sizeof(clk_dump_rec);
+    }
+
+    __ALWAYS_INLINE__
+    inline size_t size() const {
+        return (sizeof(clk_dump_ret) + num_recs * sizeof(clk_dump_rec) + sizeof(mword) - 1)
+               / sizeof(mword);
+    }
+};
+
+/* what STATS_GET reports */
+enum stats_set : uint32 {
+    STATS_METHODS, // method_stats_rec, indexed by method
+    STATS_CLOCKS,  // clk_stats_rec, clocks without a counter are skipped
+    STATS_MMIO,    // mmio_stats_rec, indexed by clock kind, ENOTSUP without IMX_MMIO_TRACE
+};
+
+struct stats_get_args : header {
+    stats_set set;
+    uint32 cursor; // first method or clock id to report
+
+    stats_get_args(stats_set _set, uint32 _cursor)
+        : header(STATS_GET), set(_set), cursor(_cursor) {}
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t size() {
+        return (sizeof(stats_get_args) + sizeof(mword) - 1) / sizeof(mword);
+    }
+};
+
+/* portal calls of one method, latencies in generic timer ticks */
+struct method_stats_rec {
+    static constexpr uint8 BUCKETS = 24;
+
+    uint32 method;
+    uint32 calls;
+    uint32 errors; // errno other than ENONE and EINPROGRESS
+    uint32 reserved;
+    uint64 ticks;
+    uint32 hist[BUCKETS]; // bucket i counts calls of [2^(i-1), 2^i) ticks, bucket 0 below 1
+};
+
+struct clk_stats_rec {
+    uint16 id;
+    uint16 reserved;
+    uint32 mmio_reads; // hardware accesses, the ones served by the shadow are not counted
+    uint32 mmio_writes;
+    uint32 pll_waits; // lock and divider acknowledge waits, PLLs only
+    uint64 pll_wait_ticks;
+};
+
+/* traced register accesses of one clock kind, over the last MMIO_TRACE_ENTRIES accesses */
+struct mmio_stats_rec {
+    uint8 kind;
+    uint8 reserved[3];
+    uint32 reads;
+    uint32 writes;
+    uint32 hw_reads; // not served by the shadow register file
+    uint32 hw_writes;
+    uint32 redundant_reads; // of a value read before, nothing written since
+    uint32 known_reads;     // of a value written before
+    uint32 noop_writes;     // of the value the register already had
+};
+
+/**
+ * Records of the requested set from cursor on, as many as fit the UTCB. Call again with
+ * cursor until it is NUM_METHODS, get_max_clkid() or the number of clock kinds. freq
+ * converts ticks to seconds.
+ */
+struct stats_get_ret : ret {
+    uint32 cursor;
+    uint32 num_recs;
+    uint64 freq;
+    uint64 recs[]; // method_stats_rec, clk_stats_rec or mmio_stats_rec, by the requested set
+
+    method_stats_rec *methods() { return reinterpret_cast<method_stats_rec *>(recs); }
+    clk_stats_rec *clocks() { return reinterpret_cast<clk_stats_rec *>(recs); }
+    mmio_stats_rec *mmio() { return reinterpret_cast<mmio_stats_rec *>(recs); }
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t rec_size(stats_set set) {
+        return (set == STATS_METHODS)  ? sizeof(method_stats_rec)
+               : (set == STATS_MMIO) ? sizeof(mmio_stats_rec)
+                                     : sizeof(clk_stats_rec);
+    }
+
+    __ALWAYS_INLINE__
+    constexpr static inline size_t max_recs(stats_set set) {
+        return (IPC_BUFFER_SIZE - sizeof(stats_get_ret)) / rec_size(set);
+    }
+
+    __ALWAYS_INLINE__
+    inline size_t size(stats_set set) const {
+        return (sizeof(stats_get_ret) + num_recs * rec_size(set) + sizeof(mword) - 1)
+               / sizeof(mword);
+    }
+};
+
+/* clears the method and clock counters */
+struct stats_reset_args : header {
+    stats_reset_args(void) : header(STATS_RESET) {}
+};
+
+struct stats_reset_ret : ret {};
+
+/**
+ * Clock status page. The driver shares it read-only with its clients, rate and enable
+ * queries are then plain loads instead of portal calls. The driver updates it on every
+ * change of the clock tree. gen is odd during an update, a reader retries if gen was odd
+ * or changed while it read, see read(). It fills its page, so that sharing the page shares
+ * nothing else of the driver.
+ */
+struct alignas(PAGE_SIZE) clk_status_page {
+    static constexpr uint32 VERSION = 1;
+    static constexpr uint16 NO_PARENT = 0xffff;
+    static constexpr size_t CACHE_LINE = 64;
+
+    enum : uint8 {
+        VALID = (1u << 0), // the clock is synced, rate and parent are meaningful
+        RATE = (1u << 1),  // rate is known
+        ENABLED = (1u << 2),
+    };
+
+    struct entry {
+        uint32 rate;
+        uint16 parent; // clock id, NO_PARENT if there is none
+        uint8 flags;
+        uint8 reserved;
+    };
+
+    uint32 version;
+    uint32 num_clks;
+    uint32 gen;
+    alignas(CACHE_LINE) entry clk[IMX8MQ_CLK_END];
+
+    /* client side: consistent copy of one entry, false for an unknown id */
+    bool read(uint64 clk_id, entry &e) const {
+        if (clk_id >= __atomic_load_n(&num_clks, __ATOMIC_RELAXED)) return false;
+
+        const uint32 *src = reinterpret_cast<const uint32 *>(&clk[clk_id]);
+        uint32 words[sizeof(entry) / sizeof(uint32)];
+        for (;;) {
+            uint32 g = __atomic_load_n(&gen, __ATOMIC_ACQUIRE);
+            if (g & 1) continue;
+            for (uint8 i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+                words[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&gen, __ATOMIC_RELAXED) == g) break;
+        }
+        __builtin_memcpy(&e, words, sizeof(entry));
+        return true;
+    }
+};
+
+static_assert(sizeof(clk_status_page) == PAGE_SIZE, "status page is exactly one page");
+static_assert(sizeof(clk_status_page::entry) % sizeof(uint32) == 0, "entries are read by word");
+
 }
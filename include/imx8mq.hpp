@@ -8,6 +8,7 @@
 #include <config.hpp>
 #include <drv_ipc.hpp>
 #include <imxclock.hpp>
+#include <spinlock.hpp>
 
 /*get our devices mapped to these VAs*/
 static constexpr uint32 ANATOP_VA = 0x40000000;
@@ -16,8 +17,20 @@ static constexpr uint32 CCM_VA = (ANATOP_VA + ANATOP_SIZE);
 static constexpr uint32 CCM_SIZE = 0x10000;
 static constexpr uint32 DEV_MMIO_END = (CCM_VA + CCM_SIZE);
 
+/**
+ * Clock service, called concurrently from the service ECs of all CPUs and the async worker.
+ * A change locks the domain of the PLL its clock runs from, then _tree which guards the
+ * clock state. PLL waits hand _tree back while they pause, so changes in other domains and
+ * queries of unsynced clocks make progress meanwhile. Rate, enable and describe queries
+ * read the published clock state without taking a lock.
+ */
 class Imx8mq {
 public:
+    Imx8mq(void) : _pause(_tree), _next_ticket(0) {
+        for (uint16 i = 0; i < CLK_ASYNC_JOBS; i++)
+            _jobs[i].state = Clk_job::FREE;
+    }
+
     Errno probe(Pbl::Utcb *utcb, const char *ccm, const char *anatop);
 
     Errno enable_clk(uint64 clk_id);
@@ -28,6 +41,11 @@ public:
 
     Errno set_clkrate(uint64 clk_id, uint64 value);
 
+    Errno round_clkrate(uint64 clk_id, uint64 value, uint64 &rounded);
+
+    /* one-write reparent, retune and gate of a CCM clock, see drv_ipc::clk_configure_args */
+    Errno configure(uint64 clk_id, uint64 parent_id, uint64 rate, uint32 flags);
+
     uint32 get_max_clkid(void);
 
     Errno describe_clkrate(uint64 clk_id, Pm::clk_desc &rate);
@@ -36,6 +54,104 @@ public:
 
     bool is_clk_enabled(uint64 clk_id);
 
+    void run_batch(drv_ipc::clk_batch_op *ops, uint32 num_ops);
+
+    /* per clock MMIO and PLL wait counters, see drv_ipc::stats_get_ret */
+    uint32 clk_stats(uint32 cursor, drv_ipc::clk_stats_rec *recs, uint32 max_recs,
+                     uint32 &num_recs);
+
+    void reset_stats(void);
+
+    /* redundancy report of the traced register accesses, see drv_ipc::mmio_stats_rec */
+    Errno mmio_stats(uint32 &cursor, drv_ipc::mmio_stats_rec *recs, uint32 max_recs,
+                     uint32 &num_recs);
+
+    /* lock-free snapshot of the tree, see drv_ipc::clk_dump_ret */
+    uint32 dump(uint32 cursor, drv_ipc::clk_dump_rec *recs, uint32 max_recs, uint32 &num_recs);
+
+    /* maintain the status page clients map read-only */
+    void attach_status(drv_ipc::clk_status_page *page);
+
+    Errno subscribe(const uint16 *ids, uint32 num_ids, mword sem, uint32 &sub_id);
+
+    Errno unsubscribe(uint32 sub_id);
+
+    Errno take_changes(uint32 sub_id, uint64 *changed);
+
+    /* after a change: semaphores to signal, one at a time */
+    bool next_notification(mword &sem);
+
+    /**
+     * queue CLK_ENABLE or CLK_SET_RATE, EINPROGRESS and a ticket if accepted, EBUSY while
+     * every slot is queued, running or holds a result not collected yet
+     */
+    Errno submit(drv_ipc::method op, uint64 clk_id, uint64 value, mword sem, uint32 &ticket);
+
+    /* result of a queued request, EINPROGRESS until it is done */
+    Errno async_status(uint32 ticket);
+
+    /* worker side: run the oldest queued request, false if there is none */
+    bool run_job(mword &sem);
+
 private:
+    struct Clk_job {
+        enum State : uint8 {
+            FREE,
+            QUEUED,
+            RUNNING,
+            DONE, // result not collected yet
+        };
+
+        State state;
+        drv_ipc::method op;
+        uint32 ticket;
+        Errno result;
+        uint64 clk_id;
+        uint64 value;
+        mword sem;
+    };
+
+    /* lets other requests in while a PLL locks */
+    class Tree_pause : public Pll_lock::Pause_hook {
+    public:
+        explicit Tree_pause(Spinlock &tree) : _tree(tree) {}
+        void enter(void) override { _tree.unlock(); }
+        void leave(void) override { _tree.lock(); }
+
+    private:
+        Spinlock &_tree;
+    };
+
+    /**
+     * Domain and tree lock of a change, taken in that order. A reparent also locks the
+     * domain of the new parent, domains are taken in ascending order.
+     */
+    class Write_guard {
+    public:
+        Write_guard(Imx8mq &drv, uint64 clk_id) : Write_guard(drv, clk_id, clk_id) {}
+        Write_guard(Imx8mq &drv, uint64 clk_id, uint64 other_id) : _drv(drv) {
+            drv.lock_domains(clk_id, other_id, _lo, _hi);
+        }
+        ~Write_guard() { _drv.unlock_domains(_lo, _hi); }
+
+        Write_guard(const Write_guard &) = delete;
+        Write_guard &operator=(const Write_guard &) = delete;
+
+    private:
+        Imx8mq &_drv;
+        uint8 _lo;
+        uint8 _hi;
+    };
+
+    void lock_domains(uint64 clk_id, uint64 other_id, uint8 &lo, uint8 &hi);
+
+    void unlock_domains(uint8 lo, uint8 hi);
+
     Imx_ClkCtrl _ccm;
+    Spinlock _domains[CLK_DOMAINS];
+    Spinlock _tree;
+    Tree_pause _pause;
+    Spinlock _jobs_lock;
+    uint32 _next_ticket;
+    Clk_job _jobs[CLK_ASYNC_JOBS];
 };
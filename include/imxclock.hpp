@@ -10,9 +10,15 @@
  */
 
 #pragma once
+#include <config.hpp>
+#include <drv_ipc.hpp>
 #include <imx8mq-clock.h>
-#include <pebble/io.hpp>
+#include <imxdiv.hpp>
+#include <imxlock.hpp>
+#include <imxregs.hpp>
+#include <mmiotrace.hpp>
 #include <pm.hpp>
+#include <seqlock.hpp>
 
 #define MAX_PARENTS 8U
 #define CLOCK_DIV_UP(x, y) (((x) + (y)-1) / (y))
@@ -26,26 +32,68 @@ enum : uint32 {
     CLOCK_DISABLE_PARENT = (1u << 4),     // disable parent permitted
     CLOCK_CHANGE_RATE = (1u << 5),        // change of rate permitted
     CLOCK_CHANGE_RATE_PARENT = (1u << 6), // change of rate by changing parent permitted
+    CLOCK_CRITICAL = (1u << 7),           // keeps running, never gated
+};
+
+class Clock;
+
+/* implementation of a clock, one per Clock subclass */
+enum Clk_kind : uint8 {
+    CLK_FIXED,
+    CLK_FIXDIV,
+    CLK_MUX,
+    CLK_DIV,
+    CLK_GATE,
+    CLK_FRAC_PLL,
+    CLK_SCCG_PLL,
+    CLK_CCM,
+    CLK_KINDS
+};
+
+/**
+ * Compile-time description of a clock, the tree is the clk_defs table in imxclock.cpp.
+ * Parents are referenced by id and resolved to objects when the table is instantiated.
+ */
+struct Clk_def {
+    uint16 id;
+    Clk_kind kind;
+    uint8 shift; // mux/div field, gate enable field
+    uint8 width;
+    uint8 num_parents;
+    uint16 flags;
+    uint32 val; // fixed: rate, fixdiv: divider
+    mword reg;
+    uint16 parents[MAX_PARENTS];
+};
+
+/* resolved parents of a clock, nullptr padded */
+struct Clk_parents {
+    Clock *clk[MAX_PARENTS];
 };
 
 /*generic clock*/
 class Clock {
-public:
-    virtual ~Clock() {}
-
-    Clock() : _id(0), _rate(0), _enabled(false), _reg(0), _parent(nullptr), _flags(0) {}
+    friend class Imx_ClkCtrl;
 
-    Clock(uint32 id, mword addr, Clock *parent, uint16 flags)
-        : _id(id), _rate(0), _enabled(false), _reg(addr), _parent(parent), _flags(flags) {}
+public:
+    /**
+     * Memoized rate, maintained by Imx_ClkCtrl. The rate is valid if it was computed
+     * in a generation at or after the last invalidation of this clock's subtree.
+     */
+    struct Rate_cache {
+        uint32 rate;
+        uint32 gen;   // generation the rate was computed in, 0 if never
+        uint32 stale; // generation the clock was last invalidated in
 
-    Clock(uint32 id, Clock *parent, uint32 rate)
-        : _id(id), _rate(rate), _enabled(false), _reg(0), _parent(parent), _flags(0) {}
+        constexpr Rate_cache() : rate(0), gen(0), stale(0) {}
 
-    Clock(uint32 id, Clock *parent, mword addr)
-        : _id(id), _rate(0), _enabled(false), _reg(addr), _parent(parent), _flags(0) {}
+        bool valid() const { return (gen != 0) && (gen >= stale); }
+    };
 
-    Clock(uint32 id, uint32 rate, uint16 flags)
-        : _id(id), _rate(rate), _enabled(true), _reg(0), _parent(nullptr), _flags(flags) {}
+    constexpr Clock(const Clk_def &def, Clock *parent)
+        : _id(def.id), _rate(0), _enabled(false), _reg(def.reg), _parent(parent),
+          _flags(def.flags), _kind(def.kind), _cache(), _err(Errno::ENONE), _mmio_reads(0),
+          _mmio_writes(0) {}
 
     virtual bool set_rate(uint32) = 0;
     virtual bool get_rate(uint32 &) = 0;
@@ -56,23 +104,124 @@ public:
     virtual void init(void) = 0;
     virtual bool is_enabled(void) { return _enabled; }
     virtual bool describe_rate(Pm::clk_desc &) = 0;
+    // rate set_rate would achieve for the request, without touching the hardware
+    virtual bool round_rate(uint32, uint32 &) { return false; }
+    // set_rate is forwarded to the parent, a rate change affects the parent's subtree
+    virtual bool propagates_rate(void) const { return false; }
+    // candidate parents, whether selected or not
+    virtual uint8 num_parents(void) const { return (_parent != nullptr) ? 1 : 0; }
+    virtual Clock *parent_at(uint8 idx) const { return (idx == 0) ? _parent : nullptr; }
+    // lock wait statistics, PLLs only
+    virtual const Pll_lock::Stats *lock_stats(void) const { return nullptr; }
+    virtual void reset_lock_stats(void) {}
     uint32 get_id() { return _id; }
+    Clk_kind kind(void) const { return _kind; }
+    // the clock and every gate up to the root it depends on is enabled
+    inline bool running(void);
 
 protected:
+    // clocks are statically allocated and never destroyed, the destructor stays trivial
+    ~Clock() = default;
+
+    // all register accesses go through the shadow register file, the ones that reach the
+    // hardware are counted per clock and all of them traced with IMX_MMIO_TRACE
+    uint32 rd(mword addr) {
+        uint64 reads = imx_regs.hw_reads();
+        uint32 val = imx_regs.read(addr);
+        uint32 hw = static_cast<uint32>(imx_regs.hw_reads() - reads);
+        _mmio_reads += hw;
+        trace(addr, val, hw ? Mmio_trace::HW : 0);
+        return val;
+    }
+    uint32 rd_hw(mword addr) {
+        _mmio_reads++;
+        uint32 val = imx_regs.read_hw(addr);
+        trace(addr, val, Mmio_trace::HW | Mmio_trace::VOLATILE);
+        return val;
+    }
+    void wr(mword addr, uint32 val) {
+        uint64 writes = imx_regs.hw_writes();
+        imx_regs.write(addr, val);
+        uint32 hw = static_cast<uint32>(imx_regs.hw_writes() - writes);
+        _mmio_writes += hw;
+        trace(addr, val, static_cast<uint8>(Mmio_trace::WRITE | (hw ? Mmio_trace::HW : 0)));
+    }
+    // single bits, one write to the SET/CLR alias where there is one
+    void set_bits(mword addr, uint32 bits) { update_bits(addr, bits, Mmio_trace::SET); }
+    void clr_bits(mword addr, uint32 bits) { update_bits(addr, bits, Mmio_trace::CLR); }
+    void update_bits(mword addr, uint32 bits, uint8 op) {
+        uint64 reads = imx_regs.hw_reads(), writes = imx_regs.hw_writes();
+        if (op == Mmio_trace::SET)
+            imx_regs.set_bits(addr, bits);
+        else
+            imx_regs.clr_bits(addr, bits);
+        _mmio_reads += static_cast<uint32>(imx_regs.hw_reads() - reads);
+        uint32 hw = static_cast<uint32>(imx_regs.hw_writes() - writes);
+        _mmio_writes += hw;
+        trace(addr, bits, static_cast<uint8>(Mmio_trace::WRITE | op | (hw ? Mmio_trace::HW : 0)));
+    }
+    // one read and one write for all fields of txn, returns the value written
+    uint32 commit(const Reg_txn &txn) {
+        uint32 reg = txn.apply(rd(txn.addr()));
+        wr(txn.addr(), reg);
+        return reg;
+    }
+    void trace(mword addr, uint32 val, uint8 flags) {
+#if IMX_MMIO_TRACE
+        mmio_trace.record(addr, val, _id, _kind, flags);
+#else
+        (void)addr, (void)val, (void)flags;
+#endif
+    }
+
+    // rate of the current parent, memoized if it was computed before
+    inline bool parent_rate(uint32 &rate);
+    static inline bool rate_of(Clock *clk, uint32 &rate);
+
+    // reason of the last failed operation, if more specific than EINVAL; cleared when read
+    Errno take_error(void) {
+        Errno err = _err;
+        _err = Errno::ENONE;
+        return err;
+    }
+
     uint32 _id;
     uint32 _rate;
     bool _enabled;
     mword _reg;
     Clock *_parent;
     uint16 _flags;
+    Clk_kind _kind;
+    Rate_cache _cache;
+    Errno _err;
+    uint32 _mmio_reads;
+    uint32 _mmio_writes;
 };
 
+/* kinds with an enable bit or power down of their own, the others follow their parent */
+static inline bool
+has_gate(const Clock *clk) {
+    Clk_kind kind = clk->kind();
+    return (kind == CLK_GATE) || (kind == CLK_CCM) || (kind == CLK_FRAC_PLL)
+           || (kind == CLK_SCCG_PLL);
+}
+
+inline bool
+Clock::running(void) {
+    for (Clock *clk = this; clk != nullptr; clk = clk->_parent)
+        if (has_gate(clk) && !clk->is_enabled()) return false;
+    return true;
+}
+
 /**
  * No operations, fixed rate. No gating.
  */
 class Imx_fixed_clock : public Clock {
 public:
-    Imx_fixed_clock(uint32 id, uint32 rate) : Clock(id, rate, CLOCK_FIXED) {}
+    constexpr Imx_fixed_clock(const Clk_def &def, const Clk_parents &) : Clock(def, nullptr) {
+        _rate = def.val;
+        _enabled = true;
+    }
 
     bool set_rate(uint32) override { return false; }
 
@@ -104,11 +253,12 @@ public:
  */
 class Imx_fixdiv_clock : public Clock {
 public:
-    Imx_fixdiv_clock(uint32 id, Clock *parent, uint8, uint8 div)
-        : Clock(id, parent, static_cast<uint32>(0)), _div(div) {}
+    constexpr Imx_fixdiv_clock(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, parents.clk[0]), _div(static_cast<uint8>(def.val)) {}
 
     bool set_rate(uint32 rate) override {
-        uint32 prate = rate * _div;
+        uint32 prate;
+        if (!Clk_div::parent_rate(rate, _div, prate)) return false;
         if (_parent->set_rate(prate)) {
             _parent->get_rate(_rate); // rate may be rounded-off
             return true;
@@ -116,9 +266,17 @@ public:
             return false;
     }
 
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        uint32 prate;
+        if (!Clk_div::parent_rate(rate, _div, prate)) return false;
+        if (!_parent->round_rate(prate, achieved)) return false;
+        achieved = achieved / _div;
+        return true;
+    }
+
     bool get_rate(uint32 &rate) override {
         if (_parent != nullptr)
-            if (_parent->get_rate(rate)) {
+            if (parent_rate(rate)) {
                 rate = rate / _div;
                 _rate = rate;
                 return true;
@@ -128,6 +286,8 @@ public:
 
     bool set_parent(Clock *) override { return false; } // no change of parent
 
+    bool propagates_rate(void) const override { return true; }
+
     bool get_parent(Clock **parent) override {
         if (_parent != nullptr) {
             *parent = _parent;
@@ -153,7 +313,7 @@ public:
             return;
         }
 
-        if (_parent->get_rate(_rate)) {
+        if (parent_rate(_rate)) {
             _rate = _rate / _div;
         }
         _enabled = _parent->is_enabled();
@@ -176,18 +336,11 @@ class Imx_clock_mux : public Clock {
 
 public:
     // Default mux - don't change parent when requested to change rate.
-    Imx_clock_mux(uint32 id, mword addr, uint8 shift, uint8 width, Clock *parents[],
-                  uint8 num_parents)
-        : Clock(id, addr, nullptr, 0), _shift(shift), _width(width), _num_parents(num_parents) {
-        for (uint8 i = 0; i < MAX_PARENTS; i++)
-            _parents[i] = (num_parents < MAX_PARENTS) ? parents[i] : nullptr;
-    }
-
-    Imx_clock_mux(uint32 id, mword addr, uint8 shift, uint8 width, Clock *parents[],
-                  uint8 num_parents, uint16 flags)
-        : Clock(id, addr, nullptr, flags), _shift(shift), _width(width), _num_parents(num_parents) {
+    constexpr Imx_clock_mux(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, nullptr), _shift(def.shift), _width(def.width),
+          _num_parents(def.num_parents), _parents() {
         for (uint8 i = 0; i < MAX_PARENTS; i++)
-            _parents[i] = (num_parents < MAX_PARENTS) ? parents[i] : nullptr;
+            _parents[i] = parents.clk[i];
     }
 
     bool set_rate(uint32 rate) override {
@@ -197,13 +350,28 @@ public:
             return false;
     }
 
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        if (_parent != nullptr)
+            return _parent->round_rate(rate, achieved);
+        else
+            return false;
+    }
+
     bool get_rate(uint32 &rate) override {
         if (_parent != nullptr)
-            return _parent->get_rate(rate);
+            return parent_rate(rate);
         else
             return false;
     }
 
+    bool propagates_rate(void) const override { return true; }
+
+    uint8 num_parents(void) const override { return _num_parents; }
+
+    Clock *parent_at(uint8 idx) const override {
+        return (idx < _num_parents) ? _parents[idx] : nullptr;
+    }
+
     bool set_parent(Clock *parent) override {
         uint8 idx = MAX_PARENTS;
 
@@ -213,13 +381,13 @@ public:
         if (idx < _num_parents) {
             uint32 setmask = ((1u << _width) - 1) << _shift;
             uint32 clrmask = ~setmask;
-            uint32 reg = ind(_reg);
+            uint32 reg = rd(_reg);
             reg &= clrmask; // clear existing parent field
             reg |= static_cast<uint32>(idx) << _shift;
-            outd(_reg, reg);
+            wr(_reg, reg);
             _parent = parent;
             if (_flags & CLOCK_ENABLE_PARENT) _enabled = _parent->enable();
-            _parent->get_rate(_rate);
+            parent_rate(_rate);
             return true;
         } else {
             return false; // Not a valid parent for this clock
@@ -255,7 +423,7 @@ public:
     }
 
     void init(void) override {
-        uint32 reg = ind(_reg);
+        uint32 reg = rd(_reg);
 
         uint32 mask = (1u << _width) - 1;
         uint32 idx = (reg >> _shift) & mask;
@@ -267,7 +435,7 @@ public:
             } else {
                 _enabled = _parent->is_enabled();
             }
-            _parent->get_rate(_rate);
+            parent_rate(_rate);
         } else
             _enabled = false;
     }
@@ -291,40 +459,42 @@ private:
 class Imx_clock_div : public Clock {
 
 public:
-    Imx_clock_div(uint32 id, Clock *parent, mword addr, uint8 shift, uint8 width)
-        : Clock(id, parent, addr), _shift(shift), _width(width) {}
-
-    Imx_clock_div(uint32 id, Clock *parent, mword addr, uint8 shift, uint8 width, uint16 flags)
-        : Clock(id, addr, parent, flags), _shift(shift), _width(width) {}
+    constexpr Imx_clock_div(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, parents.clk[0]), _shift(def.shift), _width(def.width) {}
 
     // TODO: change parent rate if more accurate?
     bool set_rate(uint32 rate) override {
         if (_parent == nullptr) return false;
 
         uint32 prate;
-        _parent->get_rate(prate);
-
-        uint32 div = CLOCK_DIV_UP(prate, rate);
-        div = div - 1;
-        if (div <= ((1u << _width) - 1)) {
-            uint32 reg = ind(_reg);
-            reg &= ~((1u << _width) - 1);
-            reg |= div << _shift;
-            outd(_reg, reg);
-        } else
+        if (!parent_rate(prate)) return false;
+
+        uint32 div, achieved;
+        if (!Clk_div::solve(prate, rate, max_div(), Clk_div::ROUND_DOWN, div, achieved))
             return false; // invalid divider
 
+        uint32 reg = rd(_reg);
+        reg &= ~((max_div() - 1) << _shift);
+        reg |= (div - 1) << _shift;
+        wr(_reg, reg);
+        _rate = achieved;
+
         return true;
     }
 
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        if (_parent == nullptr) return false;
+
+        uint32 prate, div;
+        if (!parent_rate(prate)) return false;
+        return Clk_div::solve(prate, rate, max_div(), Clk_div::ROUND_DOWN, div, achieved);
+    }
+
     bool get_rate(uint32 &rate) override {
         if (_parent != nullptr) {
             uint32 prate;
-            if (_parent->get_rate(prate)) {
-                uint32 div;
-                uint32 reg = ind(_reg);
-                div = (reg >> _shift) & ((1u << _width) - 1);
-                rate = prate / div;
+            if (parent_rate(prate)) {
+                rate = Clk_div::rate_of(prate, cur_div());
                 _rate = rate;
                 return true;
             } else {
@@ -361,11 +531,8 @@ public:
             return;
         }
         uint32 prate;
-        if (_parent->get_rate(prate)) {
-            uint32 div;
-            uint32 reg = ind(_reg);
-            div = (reg >> _shift) & ((1u << _width) - 1);
-            _rate = prate / (div + 1);
+        if (parent_rate(prate)) {
+            _rate = Clk_div::rate_of(prate, cur_div());
             if (_flags & CLOCK_ENABLE_PARENT)
                 _enabled = _parent->enable();
             else
@@ -398,6 +565,10 @@ public:
     }
 
 private:
+    uint32 max_div(void) const { return 1u << _width; }
+
+    uint32 cur_div(void) { return ((rd(_reg) >> _shift) & (max_div() - 1)) + 1; }
+
     uint8 _shift;
     uint8 _width;
 };
@@ -408,17 +579,15 @@ private:
 class Imx_clock_gate : public Clock {
 
 public:
-    Imx_clock_gate(uint32 id, Clock *parent, mword addr, uint8 bit, uint8 en_val)
-        : Clock(id, parent, addr), _bit(bit), _en_val(en_val) {}
-
-    Imx_clock_gate(uint32 id, Clock *parent, mword addr, uint8 bit, uint8 en_val, uint16 flags)
-        : Clock(id, addr, parent, flags), _bit(bit), _en_val(en_val) {}
+    constexpr Imx_clock_gate(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, parents.clk[0]), _bit(def.shift),
+          _en_val(static_cast<uint8>((1u << def.width) - 1)) {}
 
     bool set_rate(uint32) override { return false; }
 
     bool get_rate(uint32 &rate) override {
         if (_parent != nullptr)
-            return _parent->get_rate(rate);
+            return parent_rate(rate);
         else
             return false;
     }
@@ -437,18 +606,14 @@ public:
             if (!_parent->enable()) return false;
         }
 
-        uint32 reg = ind(_reg);
-        reg |= static_cast<uint32>(_en_val) << _bit; // 0x1 for regular gate, 0x3 for ccm target
-        outd(_reg, reg);
+        set_bits(_reg, static_cast<uint32>(_en_val) << _bit); // 0x1 for regular gate, 0x3 for ccm target
         _enabled = true;
         return true;
     }
 
     // disabling a gated clock always succeeds
     bool disable(void) override {
-        uint32 reg = ind(_reg);
-        reg &= ~(static_cast<uint32>(_en_val) << _bit);
-        outd(_reg, reg);
+        clr_bits(_reg, static_cast<uint32>(_en_val) << _bit);
         _enabled = false;
         return true;
     }
@@ -467,10 +632,10 @@ public:
             }
         }
 
-        uint32 reg = ind(_reg);
+        uint32 reg = rd(_reg);
         uint32 enabled = reg & (static_cast<uint32>(_en_val) << _bit);
-        _enabled = (enabled == 0);
-        _parent->get_rate(_rate);
+        _enabled = (enabled != 0);
+        parent_rate(_rate);
     }
 
     bool describe_rate(Pm::clk_desc &desc) override {
@@ -541,47 +706,66 @@ public:
         return (frac << Cfg1::PLL_FRAC_DIV_CTL_SHIFT) & Cfg1::PLL_FRAC_DIV_CTL_MASK;
     }
 
-    Frac_pll(uint32 id, Clock *parent, mword addr) : Clock(id, parent, addr) {}
+    constexpr Frac_pll(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, parents.clk[0]), _lock() {}
+
+    /**
+     * Feedback dividers for rate with the output divider at 2:
+     * PLLOUT = REF * 8 * (DIVFI + DIVFF / 2^24) / 2
+     */
+    static bool calc_divs(uint32 prate, uint32 rate, uint32 &divint, uint32 &divfrac,
+                          uint32 &achieved) {
+        uint64 prate64 = static_cast<uint64>(prate) * 8;
+        uint64 rate64 = static_cast<uint64>(rate) * 2;
+        if (prate64 == 0) return false;
+
+        uint64 fi = rate64 / prate64;
+        if ((fi == 0) || (fi > (PLL_INT_DIV_CTL_MASK >> PLL_INT_DIV_CTL_SHIFT) + 1)) return false;
+
+        uint64 ff = ((rate64 - prate64 * fi) << 24) / prate64; // 2^24 factor
+        divint = static_cast<uint32>(fi);
+        divfrac = static_cast<uint32>(ff);
+        achieved = static_cast<uint32>((prate64 * fi + ((prate64 * ff) >> 24)) / 2);
+        return true;
+    }
+
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        uint32 prate, divint, divfrac;
+        if (!parent_rate(prate)) return false;
+        return calc_divs(prate, rate, divint, divfrac, achieved);
+    }
 
     bool set_rate(uint32 rate) override {
         uint32 prate;
-        if (!_parent->get_rate(prate)) return false;
-        uint32 cfg0, cfg1, divfrac, divint;
-        uint64 tmp;
-        uint64 prate64 = prate * 8;
-        uint64 rate64 = rate * 2;
-        divint = static_cast<uint32>(prate64 / rate64);
+        if (!parent_rate(prate)) return false;
+        uint32 cfg0, cfg1, divfrac, divint, achieved;
+        if (!calc_divs(prate, rate, divint, divfrac, achieved)) return false;
 
-        tmp = prate64 * divint;
-        tmp = rate64 - tmp;
-        tmp = tmp * (1u << 24); // 2^24 factor
-        divfrac = static_cast<uint32>(tmp / prate64);
-
-        cfg1 = ind(_reg + 4);
+        cfg1 = rd(_reg + 4);
         cfg1 &= ~(PLL_INT_DIV_CTL_MASK | PLL_FRAC_DIV_CTL_MASK);
         cfg1 |= (divfrac << PLL_FRAC_DIV_CTL_SHIFT);
         cfg1 |= (divint - 1);
-        outd((_reg + 4), cfg1);
+        wr((_reg + 4), cfg1);
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         cfg0 &= ~PLL_OUTPUT_DIV_VAL_MASK;
-        outd(_reg, cfg0);
+        wr(_reg, cfg0);
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         cfg0 |= PLL_NEWDIV_VAL;
-        outd(_reg, cfg0);
+        wr(_reg, cfg0);
 
-        if (!(cfg0 & (PLL_BYPASS | PLL_PD))) {
-            do {
-                cfg0 = ind(_reg);
-                cfg0 &= PLL_NEWDIV_ACK;
-            } while (cfg0 == 0);
-        }
+        bool acked = true;
+        if (!(cfg0 & (PLL_BYPASS | PLL_PD))) acked = Pll_lock::wait(_reg, PLL_NEWDIV_ACK, _lock);
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         cfg0 &= ~PLL_NEWDIV_VAL;
-        outd(_reg, cfg0);
-        _rate = rate;
+        wr(_reg, cfg0);
+        if (!acked) {
+            _err = Errno::ETIMEDOUT;
+            return false;
+        }
+        _rate = achieved;
         return true;
     }
 
@@ -602,14 +786,14 @@ public:
 
     bool enable(void) override {
         if (_enabled) return true;
-        uint32 reg = ind(_reg);
+        uint32 reg = rd(_reg);
         reg &= ~PLL_PD;
-        outd(_reg, reg);
+        wr(_reg, reg);
 
-        do {
-            reg = ind(_reg);
-            reg &= PLL_LOCK;
-        } while (reg == 0);
+        if (!Pll_lock::wait(_reg, PLL_LOCK, _lock)) {
+            _err = Errno::ETIMEDOUT;
+            return false;
+        }
 
         _enabled = true;
         return true;
@@ -617,9 +801,9 @@ public:
 
     bool disable(void) override {
         if (!_enabled) return true;
-        uint32 reg = ind(_reg);
+        uint32 reg = rd(_reg);
         reg |= PLL_PD;
-        outd(_reg, reg);
+        wr(_reg, reg);
         _enabled = false;
         return true;
     }
@@ -628,13 +812,13 @@ public:
         if (_parent == nullptr) return;
 
         uint32 cfg0, cfg1, divfrac, divint, divout, prate;
-        if (!_parent->get_rate(prate)) return;
+        if (!parent_rate(prate)) return;
 
-        cfg1 = ind(_reg + 4);
+        cfg1 = rd(_reg + 4);
         divfrac = ((cfg1 & PLL_FRAC_DIV_CTL_MASK) >> PLL_FRAC_DIV_CTL_SHIFT);
         divint = cfg1 & PLL_INT_DIV_CTL_MASK;
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         divout = (cfg0 & PLL_OUTPUT_DIV_VAL_MASK);
         divout = (divout + 1) * 2;
 
@@ -646,7 +830,7 @@ public:
         tmprate = tmprate / divout;
         tmprate = tmprate + tmp;
 
-        if (!(cfg0 & PLL_PD)) _enabled = true;
+        _enabled = !(cfg0 & PLL_PD);
 
         if (cfg0 & PLL_BYPASS) {
             Clock *grandparent; // skip prediv when bypassed
@@ -660,6 +844,12 @@ public:
         desc.triplet = false;
         return get_rate(desc.min);
     }
+
+    const Pll_lock::Stats *lock_stats(void) const override { return &_lock; }
+    void reset_lock_stats(void) override { _lock = Pll_lock::Stats(); }
+
+private:
+    Pll_lock::Stats _lock;
 };
 
 /**
@@ -745,18 +935,157 @@ public:
         return (div << Cfg2::PLL_REF_DIVR2_SHIFT) & Cfg2::PLL_REF_DIVR2_MASK;
     }
 
-    Sccg_pll_clk(uint32 id, Clock *parent, mword addr, bool critical)
-        : Clock(id, parent, addr), _is_critical(critical) {}
+    /* operating ranges of the two stages, in Hz */
+    static constexpr uint32 STAGE1_REF_MIN = 25000000;
+    static constexpr uint32 STAGE1_REF_MAX = 54000000;
+    static constexpr uint32 STAGE1_VCO_MIN = 1600000000;
+    static constexpr uint32 STAGE1_VCO_MAX = 2400000000;
+    static constexpr uint32 STAGE2_REF_MIN = 54000000;
+    static constexpr uint32 STAGE2_REF_MAX = 75000000;
+    static constexpr uint32 STAGE2_VCO_MIN = 1200000000;
+    static constexpr uint32 STAGE2_VCO_MAX = 2400000000;
+    static constexpr uint32 OUT_MIN = 20000000;
+    static constexpr uint32 OUT_MAX = 1200000000;
+
+    /* register values of the dividers, the divisors are one more */
+    struct Divs {
+        uint32 divr1, divr2, divf1, divf2, divq;
+        bool bypass; // PLL_BYPASS2, the output is the reference
+    };
+
+    constexpr Sccg_pll_clk(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, parents.clk[0]), _is_critical(def.flags & CLOCK_CRITICAL), _lock() {}
+
+    /**
+     * Dividers for the rate closest to rate with both stages in their ranges:
+     * PLLOUT = REF * 2 * (DIVF1 + 1) * (DIVF2 + 1) / ((DIVR1 + 1) * (DIVR2 + 1) * (DIVQ + 1))
+     * A rate equal to the reference bypasses the PLL.
+     */
+    static bool calc_divs(uint32 prate, uint32 rate, Divs &divs, uint32 &achieved) {
+        if ((prate != 0) && (rate == prate)) {
+            divs = Divs{0, 0, 0, 0, 0, true};
+            achieved = prate;
+            return true;
+        }
+        if ((rate < OUT_MIN) || (rate > OUT_MAX)) return false;
+
+        uint64 q_min = (static_cast<uint64>(STAGE2_VCO_MIN) + rate - 1) / rate;
+        uint64 q_max = STAGE2_VCO_MAX / rate;
+        if (q_max > (PLL_OUTPUT_DIV_VAL_MASK >> PLL_OUTPUT_DIV_VAL_SHIFT) + 1)
+            q_max = (PLL_OUTPUT_DIV_VAL_MASK >> PLL_OUTPUT_DIV_VAL_SHIFT) + 1;
+
+        uint32 best = 0;
+        for (uint32 r1 = 0; r1 <= (PLL_REF_DIVR1_MASK >> PLL_REF_DIVR1_SHIFT); r1++) {
+            uint64 ref1 = prate / (r1 + 1);
+            if (ref1 < STAGE1_REF_MIN) break;
+            if (ref1 > STAGE1_REF_MAX) continue;
+
+            for (uint32 f1 = 0; f1 <= (PLL_FEEDBACK_DIVF1_MASK >> PLL_FEEDBACK_DIVF1_SHIFT); f1++) {
+                uint64 vco1 = ref1 * 2 * (f1 + 1);
+                if (vco1 > STAGE1_VCO_MAX) break;
+                if (vco1 < STAGE1_VCO_MIN) continue;
+
+                for (uint32 r2 = 0; r2 <= (PLL_REF_DIVR2_MASK >> PLL_REF_DIVR2_SHIFT); r2++) {
+                    uint64 ref2 = vco1 / (r2 + 1);
+                    if (ref2 < STAGE2_REF_MIN) break;
+                    if (ref2 > STAGE2_REF_MAX) continue;
+
+                    // the feedback divider closest to the rate on either side, for each
+                    // output divider that keeps stage 2 in range
+                    uint64 num = static_cast<uint64>(prate) * 2 * (f1 + 1);
+                    uint64 den = static_cast<uint64>(r1 + 1) * (r2 + 1);
+
+                    for (uint64 q = (q_min > 1) ? q_min : 1; q <= q_max; q++) {
+                        uint64 f = (static_cast<uint64>(rate) * q * den) / num;
+                        for (uint64 f2 = (f > 1) ? f : 1; f2 <= f + 1; f2++) {
+                            if (f2 > (PLL_FEEDBACK_DIVF2_MASK >> PLL_FEEDBACK_DIVF2_SHIFT) + 1) break;
+                            uint64 vco2 = ref2 * f2;
+                            if ((vco2 < STAGE2_VCO_MIN) || (vco2 > STAGE2_VCO_MAX)) continue;
+
+                            uint64 out = (num * f2) / (den * q);
+                            if ((out < OUT_MIN) || (out > OUT_MAX)) continue;
+
+                            uint32 diff = static_cast<uint32>((out > rate) ? (out - rate) : (rate - out));
+                            uint32 best_diff = (best > rate) ? (best - rate) : (rate - best);
+                            if ((best != 0) && (diff >= best_diff)) continue;
+
+                            best = static_cast<uint32>(out);
+                            divs = Divs{r1, r2, f1, static_cast<uint32>(f2 - 1),
+                                        static_cast<uint32>(q - 1), false};
+                            if (diff == 0) {
+                                achieved = best;
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        achieved = best;
+        return best != 0;
+    }
+
+    // a critical PLL is not retuned, it stays at its current rate
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        if (_is_critical) return get_rate(achieved);
+
+        uint32 prate;
+        Divs divs;
+        if (!parent_rate(prate)) return false;
+        return calc_divs(prate, rate, divs, achieved);
+    }
+
+    /**
+     * The output switches to the reference through PLL_BYPASS2 while the new dividers
+     * lock, consumers never see the VCO in between. A PLL that fails to lock stays
+     * bypassed. DRAM and SYS3 run the system and are not retuned.
+     */
+    bool set_rate(uint32 rate) override {
+        if (_is_critical) {
+            _err = Errno::EBUSY;
+            return false;
+        }
+
+        uint32 prate, achieved;
+        Divs divs;
+        if (!parent_rate(prate)) return false;
+        if (!calc_divs(prate, rate, divs, achieved)) return false;
 
-    bool set_rate(uint32) override { return true; }
+        uint32 cfg0 = rd(_reg);
+        wr(_reg, cfg0 | PLL_BYPASS2);
+        if (divs.bypass) {
+            _rate = achieved;
+            return true;
+        }
+
+        uint32 cfg2 = rd(_reg + 0x8);
+        cfg2 &= ~(PLL_REF_DIVR1_MASK | PLL_REF_DIVR2_MASK | PLL_FEEDBACK_DIVF1_MASK
+                  | PLL_FEEDBACK_DIVF2_MASK | PLL_OUTPUT_DIV_VAL_MASK);
+        cfg2 |= PLL_REF_DIVR1_VAL(divs.divr1) | PLL_REF_DIVR2_VAL(divs.divr2)
+                | PLL_FEEDBACK_DIVF1_VAL(divs.divf1) | PLL_FEEDBACK_DIVF2_VAL(divs.divf2)
+                | PLL_OUTPUT_DIV_VAL(divs.divq);
+        wr(_reg + 0x8, cfg2);
+
+        // a powered down PLL locks when it is enabled
+        if (!(cfg0 & PLL_PD) && !Pll_lock::wait(_reg, PLL_LOCK, _lock)) {
+            _err = Errno::ETIMEDOUT;
+            return false;
+        }
+
+        cfg0 = rd(_reg);
+        wr(_reg, cfg0 & ~(PLL_BYPASS1 | PLL_BYPASS2));
+        _rate = achieved;
+        return true;
+    }
 
     bool get_rate(uint32 &rate) override {
         if (_parent == nullptr) return false;
 
         uint32 prate;
-        if (!_parent->get_rate(prate)) return false;
+        if (!parent_rate(prate)) return false;
 
-        uint32 cfg1 = ind(_reg + 0x4);
+        uint32 cfg1 = rd(_reg + 0x4);
         if (cfg1 & PLL_SSE) {
             // TODO: spread spectrum mode not currently supported
             return false;
@@ -766,20 +1095,20 @@ public:
         uint32 divout, cfg0, cfg2;
         uint64 tmp;
 
-        cfg2 = ind(_reg + 0x8);
+        cfg2 = rd(_reg + 0x8);
         divr1 = (cfg2 & PLL_REF_DIVR1_MASK) >> PLL_REF_DIVR1_SHIFT;
         divr2 = (cfg2 & PLL_REF_DIVR2_MASK) >> PLL_REF_DIVR2_SHIFT;
         divf1 = (cfg2 & PLL_FEEDBACK_DIVF1_MASK) >> PLL_FEEDBACK_DIVF1_SHIFT;
         divf2 = (cfg2 & PLL_FEEDBACK_DIVF2_MASK) >> PLL_FEEDBACK_DIVF2_SHIFT;
         divout = (cfg2 & PLL_OUTPUT_DIV_VAL_MASK) >> PLL_OUTPUT_DIV_VAL_SHIFT;
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         if (cfg0 & PLL_BYPASS2) {
             tmp = prate;
         } else if (cfg0 & PLL_BYPASS1) {
-            tmp = (prate * divf2) / ((divr2 + 1) * (divout + 1));
+            tmp = (static_cast<uint64>(prate) * divf2) / ((divr2 + 1) * (divout + 1));
         } else {
-            tmp = (prate * 2) * (divf1 + 1) * (divf2 + 1);
+            tmp = (static_cast<uint64>(prate) * 2) * (divf1 + 1) * (divf2 + 1);
             tmp = tmp / ((divr1 + 1) * (divr2 + 1) * (divout + 1));
         }
 
@@ -801,19 +1130,19 @@ public:
     bool enable(void) override {
         if (_enabled) return true;
 
-        uint32 cfg0 = ind(_reg);
+        uint32 cfg0 = rd(_reg);
         cfg0 &= ~PLL_PD;
-        outd(_reg, cfg0);
+        wr(_reg, cfg0);
 
         if (cfg0 & PLL_BYPASS2) {
             _enabled = true;
             return true;
         }
 
-        do {
-            cfg0 = ind(_reg);
-            cfg0 &= PLL_LOCK;
-        } while (cfg0 == 0);
+        if (!Pll_lock::wait(_reg, PLL_LOCK, _lock)) {
+            _err = Errno::ETIMEDOUT;
+            return false;
+        }
 
         _enabled = true;
         return _enabled;
@@ -823,9 +1152,9 @@ public:
         if (_is_critical) return false;
         if (!_enabled) return true;
 
-        uint32 cfg0 = ind(_reg);
+        uint32 cfg0 = rd(_reg);
         cfg0 |= PLL_PD;
-        outd(_reg, cfg0);
+        wr(_reg, cfg0);
         _enabled = false;
         return true;
     }
@@ -838,11 +1167,11 @@ public:
     void init(void) override {
         uint32 prate;
         if (_parent != nullptr)
-            _parent->get_rate(prate);
+            parent_rate(prate);
         else
             return;
 
-        uint32 cfg1 = ind(_reg + 0x4);
+        uint32 cfg1 = rd(_reg + 0x4);
         if (cfg1 & PLL_SSE) {
             // TODO: spread spectrum mode not currently supported
             return;
@@ -852,20 +1181,20 @@ public:
         uint32 divout, cfg0, cfg2;
         uint64 tmp;
 
-        cfg2 = ind(_reg + 0x8);
+        cfg2 = rd(_reg + 0x8);
         divr1 = (cfg2 & PLL_REF_DIVR1_MASK) >> PLL_REF_DIVR1_SHIFT;
         divr2 = (cfg2 & PLL_REF_DIVR2_MASK) >> PLL_REF_DIVR2_SHIFT;
         divf1 = (cfg2 & PLL_FEEDBACK_DIVF1_MASK) >> PLL_FEEDBACK_DIVF1_SHIFT;
         divf2 = (cfg2 & PLL_FEEDBACK_DIVF2_MASK) >> PLL_FEEDBACK_DIVF2_SHIFT;
         divout = (cfg2 & PLL_OUTPUT_DIV_VAL_MASK) >> PLL_OUTPUT_DIV_VAL_SHIFT;
 
-        cfg0 = ind(_reg);
+        cfg0 = rd(_reg);
         if (cfg0 & PLL_BYPASS2) {
             tmp = prate;
         } else if (cfg0 & PLL_BYPASS1) {
-            tmp = (prate * divf2) / ((divr2 + 1) * (divout + 1));
+            tmp = (static_cast<uint64>(prate) * divf2) / ((divr2 + 1) * (divout + 1));
         } else {
-            tmp = (prate * 2) * (divf1 + 1) * (divf2 + 1);
+            tmp = (static_cast<uint64>(prate) * 2) * (divf1 + 1) * (divf2 + 1);
             tmp = tmp / ((divr1 + 1) * (divr2 + 1) * (divout + 1));
         }
 
@@ -878,8 +1207,12 @@ public:
         return get_rate(desc.min);
     }
 
+    const Pll_lock::Stats *lock_stats(void) const override { return &_lock; }
+    void reset_lock_stats(void) override { _lock = Pll_lock::Stats(); }
+
 private:
     bool _is_critical;
+    Pll_lock::Stats _lock;
 };
 
 /**
@@ -906,77 +1239,126 @@ public:
         ENABLE = (0x1u << 28)
     };
 
-    Imx_ccm_clk(uint32 id, Clock *parents[8], mword addr, bool critical)
-        : Clock(id, addr, nullptr, 0), _is_critical(critical) {
+    constexpr Imx_ccm_clk(const Clk_def &def, const Clk_parents &parents)
+        : Clock(def, nullptr), _parents(), _is_critical(def.flags & CLOCK_CRITICAL) {
         for (uint8 i = 0; i < 8u; i++)
-            _parents[i] = parents[i];
-    }
-
-    Imx_ccm_clk(uint32 id, Clock *parents[8], mword addr)
-        : Clock(id, addr, nullptr, 0), _is_critical(false) {
-        for (uint8 i = 0; i < 8u; i++)
-            _parents[i] = parents[i];
+            _parents[i] = parents.clk[i];
     }
 
     bool set_rate(uint32 rate) override {
         uint32 prate;
-        if (!_parent->get_rate(prate)) return false;
-
-        uint32 pre_div = 1, post_div = 1;
-        uint32 delta1 = __UINT32_MAX__;
+        if (!parent_rate(prate)) return false;
 
-        for (uint32 pre = 1; pre <= (PRE_DIV_MAX + 1); pre++) {
-            for (uint32 post = 1; post <= (POST_DIV_MAX + 1); post++) {
-                uint32 delta2 = (((prate / pre) / post) - rate);
+        Reg_txn txn(_reg);
+        if (!set_divs(txn, prate, rate, _rate)) return false;
+        commit(txn);
+        return true;
+    }
 
-                if (((delta2 > delta1) && ((delta2 - delta1) < delta1))
-                    || ((delta1 > delta2) && ((delta1 - delta2) < delta1))) {
-                    pre_div = pre;
-                    post_div = post;
-                    delta1 = delta2;
-                }
-            }
+    bool round_rate(uint32 rate, uint32 &achieved) override {
+        if (_flags & CLOCK_CHANGE_RATE_PARENT) {
+            Clock *parent;
+            return best_parent(rate, parent, achieved);
         }
 
-        uint32 reg = ind(_reg);
-        reg &= ~(PRE_PODF_MASK | POST_PODF_MASK);
-        reg |= (pre_div - 1) << PRE_PODF_SHIFT;
-        reg |= (post_div - 1);
-        outd(_reg, reg);
-
-        _rate = CLOCK_DIV_UP(rate, pre_div);
-        _rate = CLOCK_DIV_UP(_rate, post_div);
+        uint32 prate;
+        if (!parent_rate(prate)) return false;
 
+        Clk_div::Pair div{};
+        if (!Clk_div::solve(prate, rate, PRE_DIV_MAX + 1, POST_DIV_MAX + 1,
+                            Clk_div::ROUND_NEAREST, div))
+            return false;
+        achieved = div.rate;
         return true;
     }
 
+    /**
+     * Parent for rate among the current one and the running on-chip candidates, with
+     * the rate the dividers achieve from it. The closest rate wins, but all parents
+     * within CLK_PARENT_TOLERANCE_PPM of the request are good enough and the slowest of
+     * those is taken, it burns the least power. Ties keep the current parent.
+     */
+    bool best_parent(uint32 rate, Clock *&parent, uint32 &achieved) {
+        uint64 tolerance = static_cast<uint64>(rate) * CLK_PARENT_TOLERANCE_PPM / 1000000;
+        uint32 best_prate = 0, best_diff = 0;
+        bool best_fits = false;
+
+        parent = nullptr;
+        for (uint8 i = 0; i < 8; i++) {
+            Clock *p = _parents[i];
+            if ((p == nullptr) || ((p != _parent) && (external(p) || !p->running()))) continue;
+
+            uint32 prate;
+            Clk_div::Pair div{};
+            if (!rate_of(p, prate)
+                || !Clk_div::solve(prate, rate, PRE_DIV_MAX + 1, POST_DIV_MAX + 1,
+                                   Clk_div::ROUND_NEAREST, div))
+                continue;
+
+            uint32 diff = (div.rate > rate) ? (div.rate - rate) : (rate - div.rate);
+            bool fits = diff <= tolerance;
+            bool better;
+            if (parent == nullptr)
+                better = true;
+            else if (fits != best_fits)
+                better = fits;
+            else if (fits && (prate != best_prate))
+                better = prate < best_prate;
+            else if (diff != best_diff)
+                better = diff < best_diff;
+            else
+                better = (p == _parent);
+            if (!better) continue;
+
+            parent = p;
+            achieved = div.rate;
+            best_prate = prate;
+            best_diff = diff;
+            best_fits = fits;
+        }
+        return parent != nullptr;
+    }
+
+    // from the parent and the dividers, the parent may have been retuned since
     bool get_rate(uint32 &rate) override {
+        uint32 prate;
+        if (!parent_rate(prate)) return false;
+        _rate = rate_from(prate, rd(_reg));
         rate = _rate;
         return true;
     }
 
     bool set_parent(Clock *parent) override {
-        uint8 idx = 9;
-        for (uint8 i = 0; i < 8; i++)
-            if (_parents[i] == parent) idx = i;
+        Reg_txn txn(_reg);
+        if (!set_mux(txn, parent)) return false; // Not a valid parent for this clock
 
-        if (idx < 8) {
-            uint32 reg = ind(_reg);
-            reg &= ~MUX_MASK;
-            reg |= static_cast<uint32>(idx) << MUX_SHIFT;
-            outd(_reg, reg);
-            _parent = parent;
+        uint32 reg = commit(txn);
+        _parent = parent;
 
-            uint32 rate;
-            if (_parent->get_rate(rate)) {
-                uint32 pre_div = ((reg & PRE_PODF_MASK) >> PRE_PODF_SHIFT);
-                uint32 post_div = reg & POST_PODF_MASK;
-                _rate = CLOCK_DIV_UP(rate, pre_div);
-                _rate = CLOCK_DIV_UP(_rate, post_div);
-            }
-            return true;
-        } else
-            return false; // Not a valid parent for this clock
+        uint32 rate;
+        if (parent_rate(rate)) _rate = rate_from(rate, reg);
+        return true;
+    }
+
+    /**
+     * Select parent, set the dividers for rate and gate the clock in one write to the
+     * target root, so no mix of old and new fields is ever programmed. rate 0 keeps the
+     * dividers. The caller keeps the new parent running if the clock is to run.
+     */
+    bool configure(Clock *parent, uint32 rate, bool enable) {
+        Reg_txn txn(_reg);
+        if (!set_mux(txn, parent)) return false;
+
+        uint32 prate = 0, achieved;
+        if ((rate != 0) && (!rate_of(parent, prate) || !set_divs(txn, prate, rate, achieved)))
+            return false;
+        txn.set(ENABLE, enable ? static_cast<uint32>(ENABLE) : 0);
+
+        uint32 reg = commit(txn);
+        _parent = parent;
+        _enabled = enable;
+        if ((prate != 0) || parent_rate(prate)) _rate = rate_from(prate, reg);
+        return true;
     }
 
     bool get_parent(Clock **parent) override {
@@ -984,12 +1366,14 @@ public:
         return true;
     }
 
+    uint8 num_parents(void) const override { return 8; }
+
+    Clock *parent_at(uint8 idx) const override { return (idx < 8) ? _parents[idx] : nullptr; }
+
     bool enable(void) override {
         if (!_parent->enable()) return false;
 
-        uint32 reg = ind(_reg);
-        reg |= ENABLE;
-        outd(_reg, reg);
+        set_bits(_reg, ENABLE);
         _enabled = true;
         return true;
     }
@@ -997,27 +1381,22 @@ public:
     bool disable(void) override {
         if (_is_critical) return false;
 
-        uint32 reg = ind(_reg);
-        reg &= ~ENABLE;
-        outd(_reg, reg);
+        clr_bits(_reg, ENABLE);
         _enabled = false;
         return true;
     }
 
+    bool is_critical(void) const { return _is_critical; }
+
     void init(void) override {
-        uint32 reg = ind(_reg);
+        uint32 reg = rd(_reg);
         _enabled = ((reg & ENABLE) > 0);
 
         uint8 idx = ((reg & MUX_MASK) >> MUX_SHIFT);
         _parent = _parents[idx];
 
         uint32 rate;
-        if (_parent->get_rate(rate)) {
-            uint32 pre_div = (((reg & PRE_PODF_MASK) >> PRE_PODF_SHIFT) + 1);
-            uint32 post_div = (reg & POST_PODF_MASK) + 1;
-            _rate = CLOCK_DIV_UP(rate, pre_div);
-            _rate = CLOCK_DIV_UP(_rate, post_div);
-        }
+        if (parent_rate(rate)) _rate = rate_from(rate, reg);
     }
 
     bool describe_rate(Pm::clk_desc &desc) override {
@@ -1026,16 +1405,208 @@ public:
     }
 
 private:
+    // board inputs, their nominal rate says nothing about whether anything drives them
+    static bool external(Clock *clk) {
+        return (clk->get_id() >= IMX8MQ_CLK_EXT1) && (clk->get_id() <= IMX8MQ_CLK_EXT4);
+    }
+
+    bool set_mux(Reg_txn &txn, Clock *parent) const {
+        for (uint8 i = 0; i < 8; i++) {
+            if ((parent != nullptr) && (_parents[i] == parent)) {
+                txn.set(MUX_MASK, static_cast<uint32>(i) << MUX_SHIFT);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool set_divs(Reg_txn &txn, uint32 prate, uint32 rate, uint32 &achieved) {
+        Clk_div::Pair div{};
+        if (!Clk_div::solve(prate, rate, PRE_DIV_MAX + 1, POST_DIV_MAX + 1,
+                            Clk_div::ROUND_NEAREST, div))
+            return false;
+
+        txn.set(PRE_PODF_MASK | POST_PODF_MASK,
+                ((div.pre - 1) << PRE_PODF_SHIFT) | ((div.post - 1) << POST_PODF_SHIFT));
+        achieved = div.rate;
+        return true;
+    }
+
+    static uint32 rate_from(uint32 prate, uint32 reg) {
+        uint32 pre_div = ((reg & PRE_PODF_MASK) >> PRE_PODF_SHIFT) + 1;
+        uint32 post_div = ((reg & POST_PODF_MASK) >> POST_PODF_SHIFT) + 1;
+        return Clk_div::rate_of(Clk_div::rate_of(prate, pre_div), post_div);
+    }
+
     Clock *_parents[8];
     bool _is_critical;
 };
 
+/**
+ * Clock operations dispatched on the kind tag, a direct and inlinable call with
+ * CLK_DEVIRT instead of a virtual one
+ */
+namespace Clk_ops {
+
+#if CLK_DISPATCH_STATS
+struct Dispatch_stats {
+    uint64 calls;
+    uint64 virtual_calls; // the fallback, every call without CLK_DEVIRT
+};
+
+extern thread_local Dispatch_stats dispatch_stats;
+#endif
+
+template <class Op>
+static inline bool
+dispatch(Clock *clk, Op &op) {
+#if CLK_DISPATCH_STATS
+    dispatch_stats.calls++;
+#endif
+#if CLK_DEVIRT
+    switch (clk->kind()) {
+    case CLK_FIXED:
+        return op(static_cast<Imx_fixed_clock *>(clk));
+    case CLK_FIXDIV:
+        return op(static_cast<Imx_fixdiv_clock *>(clk));
+    case CLK_MUX:
+        return op(static_cast<Imx_clock_mux *>(clk));
+    case CLK_DIV:
+        return op(static_cast<Imx_clock_div *>(clk));
+    case CLK_GATE:
+        return op(static_cast<Imx_clock_gate *>(clk));
+    case CLK_FRAC_PLL:
+        return op(static_cast<Frac_pll *>(clk));
+    case CLK_SCCG_PLL:
+        return op(static_cast<Sccg_pll_clk *>(clk));
+    case CLK_CCM:
+        return op(static_cast<Imx_ccm_clk *>(clk));
+    default:
+        break;
+    }
+#endif
+#if CLK_DISPATCH_STATS
+    dispatch_stats.virtual_calls++;
+#endif
+    return op(clk);
+}
+
+/* each op calls T::method non-virtually, the Clock overload is the virtual fallback */
+struct Get_rate {
+    uint32 &rate;
+    template <class T>
+    bool operator()(T *clk) { return clk->T::get_rate(rate); }
+    bool operator()(Clock *clk) { return clk->get_rate(rate); }
+};
+
+struct Set_rate {
+    uint32 rate;
+    template <class T>
+    bool operator()(T *clk) { return clk->T::set_rate(rate); }
+    bool operator()(Clock *clk) { return clk->set_rate(rate); }
+};
+
+struct Round_rate {
+    uint32 rate;
+    uint32 &achieved;
+    template <class T>
+    bool operator()(T *clk) { return clk->T::round_rate(rate, achieved); }
+    bool operator()(Clock *clk) { return clk->round_rate(rate, achieved); }
+};
+
+struct Enable {
+    template <class T>
+    bool operator()(T *clk) { return clk->T::enable(); }
+    bool operator()(Clock *clk) { return clk->enable(); }
+};
+
+struct Disable {
+    template <class T>
+    bool operator()(T *clk) { return clk->T::disable(); }
+    bool operator()(Clock *clk) { return clk->disable(); }
+};
+
+struct Is_enabled {
+    template <class T>
+    bool operator()(T *clk) { return clk->T::is_enabled(); }
+    bool operator()(Clock *clk) { return clk->is_enabled(); }
+};
+
+static inline bool
+get_rate(Clock *clk, uint32 &rate) {
+    Get_rate op{rate};
+    return dispatch(clk, op);
+}
+
+static inline bool
+set_rate(Clock *clk, uint32 rate) {
+    Set_rate op{rate};
+    return dispatch(clk, op);
+}
+
+static inline bool
+round_rate(Clock *clk, uint32 rate, uint32 &achieved) {
+    Round_rate op{rate, achieved};
+    return dispatch(clk, op);
+}
+
+static inline bool
+enable(Clock *clk) {
+    Enable op;
+    return dispatch(clk, op);
+}
+
+static inline bool
+disable(Clock *clk) {
+    Disable op;
+    return dispatch(clk, op);
+}
+
+static inline bool
+is_enabled(Clock *clk) {
+    Is_enabled op;
+    return dispatch(clk, op);
+}
+
+}
+
+inline bool
+Clock::parent_rate(uint32 &rate) {
+    if (_parent == nullptr) return false;
+    return rate_of(_parent, rate);
+}
+
+inline bool
+Clock::rate_of(Clock *clk, uint32 &rate) {
+    if (clk->_cache.valid()) {
+        rate = clk->_cache.rate;
+        return true;
+    }
+    return Clk_ops::get_rate(clk, rate);
+}
+
+/* writers lock the domain of the PLL a clock runs from, domain 0 is everything above the PLLs */
+static constexpr uint8 CLK_DOMAINS = 16;
+
+/* clock objects by id, nullptr for ids without a clock, built at compile time */
+struct Clk_table {
+    Clock *clk[IMX8MQ_CLK_END];
+    uint16 share[IMX8MQ_CLK_END]; // first gate on the same enable bit, else the id itself
+    uint8 domain[IMX8MQ_CLK_END]; // PLLs: their domain, 0 for other clocks
+};
+
+extern const Clk_table imx_clk_table;
+
 /**
  * manage control ops for CCM instance
  */
 class Imx_ClkCtrl {
 public:
-    Errno probe(void);
+    /**
+     * Sync the clock tree with the hardware. In lazy mode only the warm clocks are synced
+     * here, any other clock is synced with its ancestors on first use.
+     */
+    Errno probe(bool lazy = false, const uint16 *warm = nullptr, uint16 num_warm = 0);
 
     Errno enable_clk(uint64 clk_id);
 
@@ -1045,19 +1616,172 @@ public:
 
     Errno set_clkrate(uint64 clk_id, uint64 value);
 
+    /* parent a CLOCK_CHANGE_RATE_PARENT clock moves to for value, ENOTSUP for other clocks */
+    Errno rate_parent(uint64 clk_id, uint64 value, uint64 &parent_id);
+
+    /* set_clkrate from parent_id, which the clock switches to, see rate_parent */
+    Errno set_clkrate(uint64 clk_id, uint64 value, uint64 parent_id);
+
+    Errno round_clkrate(uint64 clk_id, uint64 value, uint64 &rounded);
+
+    /* CCM clocks only, see drv_ipc::clk_configure_args */
+    Errno configure(uint64 clk_id, uint64 parent_id, uint64 rate, uint32 flags);
+
     uint32 get_max_clkid(void);
 
     Errno describe_clkrate(uint64 clk_id, Pm::clk_desc &rate);
 
     bool is_enabled(uint64 clk_id);
 
-    Imx_ClkCtrl(void) {
+    /* cost of the last probe */
+    struct Probe_stats {
+        uint64 mmio_reads;
+        uint64 ticks;  // generic timer ticks
+        uint16 clocks; // initialized, in lazy mode this grows on first use
+    };
+
+    const Probe_stats &probe_stats(void) const { return _probe_stats; }
+
+    /* lock wait statistics of a PLL, ENOTSUP for other clocks */
+    Errno lock_stats(uint64 clk_id, Pll_lock::Stats &stats);
+
+    /* state of a clock as of the last change, readable without the tree lock */
+    struct Clk_state {
+        enum : uint8 {
+            VALID = (1u << 0), // published, the clock is synced
+            RATE = (1u << 1),  // rate is known
+            DESC = (1u << 2),  // desc is known
+            ENABLED = (1u << 3),
+        };
+
+        uint32 rate;
+        Pm::clk_desc desc;
+        uint8 flags;
+        uint8 parent; // index of the selected parent, NO_PARENT if there is none
+
+        static constexpr uint8 NO_PARENT = 0xff;
+    };
+
+    /* lock-free, false if the clock was not published yet */
+    bool read_state(uint64 clk_id, Clk_state &state) const {
+        if (clk_id >= IMX8MQ_CLK_END) return false;
+        _state[clk_id].read(state);
+        return state.flags & Clk_state::VALID;
+    }
+
+    /* per clock MMIO and PLL wait counters from cursor on, returns the next cursor */
+    uint32 clk_stats(uint32 cursor, drv_ipc::clk_stats_rec *recs, uint32 max_recs,
+                     uint32 &num_recs);
+
+    void reset_stats(void);
+
+    /* traced register accesses per clock kind from cursor on, ENOTSUP without IMX_MMIO_TRACE */
+    Errno mmio_stats(uint32 &cursor, drv_ipc::mmio_stats_rec *recs, uint32 max_recs,
+                     uint32 &num_recs);
+
+    /* lock-free, published records from cursor on as far as they fit, returns the next cursor */
+    uint32 dump(uint32 cursor, drv_ipc::clk_dump_rec *recs, uint32 max_recs,
+                uint32 &num_recs) const;
+
+    /* writer lock domain a change of clk_id falls in, may change with its parents */
+    uint8 domain_of(uint64 clk_id);
+
+    /* keep page up to date from now on, clients map it read-only */
+    void attach_status(drv_ipc::clk_status_page *page);
+
+    /* rate change notifications, see drv_ipc::clk_subscribe_args */
+    Errno subscribe(const uint16 *ids, uint32 num_ids, mword sem, uint32 &sub_id);
+
+    Errno unsubscribe(uint32 sub_id);
+
+    /* fetch and clear the changed clocks of a subscriber */
+    Errno take_changes(uint32 sub_id, uint64 *changed);
+
+    /* semaphore of a subscriber with unsignaled changes, false once there is none */
+    bool next_notification(mword &sem);
+
+#if defined(PBL_HOST)
+    /* test hook: forget the memoized rates of clk_id and every clock below it */
+    void drop_rates(uint64 clk_id) {
+        Clock *clk;
+        if (lookup(clk_id, clk) == Errno::ENONE) invalidate_rates(clk);
+    }
+#endif
+
+    Imx_ClkCtrl(void)
+        : _clks(imx_clk_table.clk), _generation(1), _num_ordered(0), _probe_stats(), _lazy(false),
+          _status(nullptr), _next_sub(0) {
+        for (uint16 i = 0; i < INIT_WORDS; i++)
+            _initialized[i] = 0;
         for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
-            _clks[i] = nullptr;
+            _refs[i] = _share_refs[i] = 0;
+        for (uint16 i = 0; i < CLK_SUBSCRIBERS; i++)
+            _subs[i].id = 0;
     }
 
     ~Imx_ClkCtrl() {}
 
 private:
-    Clock *_clks[IMX8MQ_CLK_END];
+    static constexpr uint16 INIT_WORDS = (IMX8MQ_CLK_END + 63) / 64;
+
+    bool is_initialized(uint16 id) const { return (_initialized[id / 64] >> (id % 64)) & 1; }
+    void set_initialized(uint16 id) { _initialized[id / 64] |= (1ull << (id % 64)); }
+
+    void init_clk(uint16 id);
+
+    void init_one(uint16 id);
+
+    Errno get_ref(Clock *clk);
+
+    Errno put_ref(Clock *clk);
+
+    Errno failure(Clock *clk, Clock *root);
+
+    Errno set_rate(Clock *clk, uint32 rate);
+
+    void publish(Clock *clk);
+
+    void publish_subtree(Clock *root);
+
+    void update_status(const Clock *clk, const Clk_state &state);
+
+    void rate_changed(uint16 id);
+
+    struct Clk_sub {
+        uint32 id; // 0 if the slot is free
+        mword sem;
+        bool pending; // changes since the last signal
+        uint64 watch[drv_ipc::CLK_ID_WORDS];
+        uint64 changed[drv_ipc::CLK_ID_WORDS];
+    };
+
+    Clock *ref_top(Clock *clk, uint16 refs);
+
+    Errno lookup(uint64 clk_id, Clock *&clk);
+
+    bool cached_rate(Clock *clk, uint32 &rate);
+
+    void invalidate_rates(Clock *root);
+
+    void build_order(void);
+
+    void visit(uint16 id, uint8 *state);
+
+    uint16 collect_subtree(Clock *root);
+
+    Clock *const *_clks;
+    uint32 _generation;
+    uint16 _order[IMX8MQ_CLK_END]; // parents before children
+    uint16 _rank[IMX8MQ_CLK_END];  // position in _order
+    uint16 _below[IMX8MQ_CLK_END]; // result of collect_subtree, used with the tree locked
+    uint16 _num_ordered;
+    Probe_stats _probe_stats;
+    bool _lazy;
+    uint64 _initialized[INIT_WORDS]; // one bit per clock id, synced with the hardware
+    uint16 _refs[IMX8MQ_CLK_END];       // enable count per clock
+    uint16 _share_refs[IMX8MQ_CLK_END]; // referenced gates per shared enable bit
+    Seq_value<Clk_state> _state[IMX8MQ_CLK_END];
+    drv_ipc::clk_status_page *_status;
+    uint32 _next_sub;
+    Clk_sub _subs[CLK_SUBSCRIBERS];
 };
\ No newline at end of file
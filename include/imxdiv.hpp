@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <pm.hpp>
+
+/**
+ * Integer divider solver shared by the divider clocks.
+ *
+ * A divider d turns a parent rate p into DIV_UP(p, d), the output rate falls monotonically
+ * with d. The best divider for a request is therefore next to DIV_UP(p, rate) and only a
+ * couple of candidates need to be evaluated. A pre/post pair is solved by running the
+ * single divider solver once per pre divider.
+ */
+namespace Clk_div {
+
+enum Round : uint8 {
+    ROUND_DOWN,    // closest rate not above the request
+    ROUND_NEAREST, // closest rate
+    ROUND_UP,      // closest rate not below the request
+};
+
+struct Pair {
+    uint32 pre;
+    uint32 post;
+    uint32 rate;
+};
+
+static inline uint32
+rate_of(uint32 prate, uint32 div) {
+    return static_cast<uint32>((static_cast<uint64>(prate) + div - 1) / div);
+}
+
+static inline uint32
+distance(uint32 a, uint32 b) {
+    return (a > b) ? (a - b) : (b - a);
+}
+
+/* does achieved satisfy the policy for requested? */
+static inline bool
+acceptable(Round round, uint32 requested, uint32 achieved) {
+    if (round == ROUND_DOWN) return achieved <= requested;
+    if (round == ROUND_UP) return achieved >= requested;
+    return true;
+}
+
+/* is candidate a strictly better answer than best for requested? */
+static inline bool
+better(Round round, uint32 requested, uint32 candidate, uint32 best) {
+    bool cand_ok = acceptable(round, requested, candidate);
+    if (cand_ok != acceptable(round, requested, best)) return cand_ok;
+    return distance(candidate, requested) < distance(best, requested);
+}
+
+/**
+ * Find a divider in [1, max] for prate -> rate. Returns false if no divider satisfies
+ * the rounding policy, div/achieved then hold the closest rate in the wrong direction.
+ */
+static inline bool
+solve(uint32 prate, uint32 rate, uint32 max, Round round, uint32 &div, uint32 &achieved) {
+    if ((max == 0) || (prate == 0)) return false;
+
+    uint32 guess = (rate == 0) ? max : rate_of(prate, rate);
+    uint32 first = (guess > 1) ? guess - 1 : 1;
+
+    div = 0;
+    for (uint32 d = first; (d <= guess + 1) && (d <= max); d++) {
+        uint32 r = rate_of(prate, d);
+        if ((div == 0) || better(round, rate, r, achieved)) {
+            div = d;
+            achieved = r;
+        }
+    }
+
+    if (div == 0) { // every candidate is above max
+        div = max;
+        achieved = rate_of(prate, max);
+    }
+
+    return acceptable(round, rate, achieved);
+}
+
+/**
+ * Find a (pre, post) pair with pre in [1, pre_max], post in [1, post_max] for
+ * prate -> rate. The output of the pre divider feeds the post divider.
+ */
+static inline bool
+solve(uint32 prate, uint32 rate, uint32 pre_max, uint32 post_max, Round round, Pair &best) {
+    if ((pre_max == 0) || (post_max == 0) || (prate == 0)) return false;
+
+    best = Pair();
+    for (uint32 pre = 1; pre <= pre_max; pre++) {
+        uint32 post = post_max, achieved = 0; // kept if the pre divider output is 0
+        solve(rate_of(prate, pre), rate, post_max, round, post, achieved);
+
+        if ((pre == 1) || better(round, rate, achieved, best.rate)) {
+            best.pre = pre;
+            best.post = post;
+            best.rate = achieved;
+        }
+    }
+
+    return acceptable(round, rate, best.rate);
+}
+
+/* parent rate needed for rate behind a fixed divider, false on overflow */
+static inline bool
+parent_rate(uint32 rate, uint32 div, uint32 &prate) {
+    uint64 tmp = static_cast<uint64>(rate) * div;
+    if (tmp > __UINT32_MAX__) return false;
+
+    prate = static_cast<uint32>(tmp);
+    return true;
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <config.hpp>
+#include <imxregs.hpp>
+#include <pm.hpp>
+#include <timer.hpp>
+
+/**
+ * Bounded wait for a PLL status bit (lock, divider acknowledge).
+ *
+ * The register is polled against the generic timer, so the budget is independent of the
+ * core frequency. The pause between polls starts at one tick and doubles up to
+ * PLL_LOCK_BACKOFF_US, the core is handed the yield hint while pausing. Every wait is
+ * recorded in the statistics of the PLL it was made for. Without a generic timer
+ * (TIMER_COUNTS_TIME) the budget is a number of polls instead, as many as fit
+ * PLL_LOCK_TIMEOUT_US at the longest pause.
+ */
+namespace Pll_lock {
+
+/* lock time distribution, bucket i counts waits of [2^(i-1), 2^i) us, bucket 0 below 1 us */
+struct Stats {
+    static constexpr uint8 BUCKETS = 16;
+
+    uint32 locks;
+    uint32 timeouts;
+    uint32 max_us;
+    uint32 hist[BUCKETS];
+    uint32 polls;       // status register reads
+    uint64 wait_ticks;  // generic timer ticks spent waiting, timeouts included
+
+    constexpr Stats() : locks(0), timeouts(0), max_us(0), hist{}, polls(0), wait_ticks(0) {}
+
+    void record(uint64 us) {
+        uint32 val = (us > ~0u) ? ~0u : static_cast<uint32>(us);
+        uint8 bucket = 0;
+        while ((bucket < BUCKETS - 1) && (val >> bucket)) bucket++;
+        hist[bucket]++;
+        if (val > max_us) max_us = val;
+        locks++;
+    }
+};
+
+/**
+ * Called around the pauses between polls. Waiters hold the clock tree lock, the hook
+ * releases it there so that other requests are served while a PLL locks.
+ */
+class Pause_hook {
+public:
+    virtual void enter(void) = 0;
+    virtual void leave(void) = 0;
+
+protected:
+    ~Pause_hook() = default;
+};
+
+extern Pause_hook *pause_hook;
+
+/* false if none of the bits came up within PLL_LOCK_TIMEOUT_US */
+static inline bool
+wait(mword reg, uint32 bits, Stats &stats) {
+    const uint64 start = Timer::now();
+#if TIMER_COUNTS_TIME
+    const uint64 budget = Timer::us_to_ticks(PLL_LOCK_TIMEOUT_US);
+#else
+    const uint64 budget = (PLL_LOCK_TIMEOUT_US + PLL_LOCK_BACKOFF_US - 1) / PLL_LOCK_BACKOFF_US;
+#endif
+    const uint64 max_pause = Timer::us_to_ticks(PLL_LOCK_BACKOFF_US);
+    uint64 pause = 1;
+    uint64 polls = 0;
+
+    for (;;) {
+        uint64 now = Timer::now();
+        stats.polls++;
+        polls++;
+        if (imx_regs.read_hw(reg) & bits) {
+            stats.wait_ticks += now - start;
+            stats.record(Timer::ticks_to_us(now - start));
+            return true;
+        }
+        if ((TIMER_COUNTS_TIME ? (now - start) : polls) >= budget) {
+            stats.wait_ticks += now - start;
+            stats.timeouts++;
+            return false;
+        }
+
+        Pause_hook *hook = pause_hook;
+        if (hook != nullptr) hook->enter();
+        while (Timer::now() - now < pause) Timer::relax();
+        if (hook != nullptr) hook->leave();
+        if (pause < max_pause) pause *= 2;
+    }
+}
+
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <config.hpp>
+#include <pebble/io.hpp>
+#include <pm.hpp>
+
+/**
+ * Shadow copy of the CCM and ANATOP registers touched by the clock tree.
+ *
+ * Both windows are owned by this driver: once a register has been loaded, reads are
+ * served from the shadow and writes that would not change it are elided. Status bits
+ * (PLL lock, NEWDIV ack) change behind our back and must be polled with read_hw().
+ * Registers are tracked lazily in a small open-addressed table, accesses outside the
+ * owned windows or beyond the table capacity go straight to the hardware.
+ *
+ * In a window with SET/CLR aliases (the CCM) set_bits and clr_bits are a single write to
+ * the alias, the register is not read. Elsewhere they fall back to read-modify-write.
+ */
+class Imx_regfile {
+public:
+    static constexpr uint16 MAX_REGS = 256;
+
+    struct Reg_stats {
+        mword addr;
+        uint32 hw_reads;
+        uint32 hw_writes;
+        uint32 reads_saved;
+        uint32 writes_saved;
+    };
+
+    static constexpr mword SET_OFFSET = 0x4;
+    static constexpr mword CLR_OFFSET = 0x8;
+
+    /* windows whose registers have SET/CLR aliases */
+    enum : uint8 {
+        ALIASED0 = (1u << 0),
+        ALIASED1 = (1u << 1),
+    };
+
+    constexpr Imx_regfile(mword base0, mword size0, mword base1, mword size1, uint8 aliased = 0)
+        : _base{base0, base1}, _size{size0, size1}, _aliased(aliased), _regs{}, _hw_reads(0),
+          _hw_writes(0) {}
+
+    uint32 read(mword addr) {
+        Entry *e = lookup(addr);
+        if (e == nullptr) return raw_read(addr);
+
+        if (e->valid) {
+            e->stats.reads_saved++;
+            return e->val;
+        }
+        return load(e);
+    }
+
+    // always read the hardware, used to poll status bits
+    uint32 read_hw(mword addr) {
+        Entry *e = lookup(addr);
+        if (e == nullptr) return raw_read(addr);
+        return load(e);
+    }
+
+    void write(mword addr, uint32 val) {
+        Entry *e = lookup(addr);
+        if (e == nullptr) {
+            raw_write(addr, val);
+            return;
+        }
+
+        if (e->valid && (e->val == val)) {
+            e->stats.writes_saved++;
+            return;
+        }
+        raw_write(addr, val);
+        e->stats.hw_writes++;
+        e->val = val;
+        e->valid = true;
+    }
+
+    void set_bits(mword addr, uint32 bits) { update_bits(addr, bits, true); }
+    void clr_bits(mword addr, uint32 bits) { update_bits(addr, bits, false); }
+
+    // forget the shadow of a register, e.g. after a reset of the block
+    void invalidate(mword addr) {
+        Entry *e = lookup(addr);
+        if (e != nullptr) e->valid = false;
+    }
+
+    /* iterate over the tracked registers, idx in [0, MAX_REGS) */
+    bool stats(uint16 idx, Reg_stats &stats) const {
+        if ((idx >= MAX_REGS) || (_regs[idx].stats.addr == 0)) return false;
+        stats = _regs[idx].stats;
+        return true;
+    }
+
+    /* all hardware accesses, tracked or not */
+    uint64 hw_reads(void) const { return _hw_reads; }
+    uint64 hw_writes(void) const { return _hw_writes; }
+
+    uint64 total_saved(void) const {
+        uint64 saved = 0;
+        for (uint16 i = 0; i < MAX_REGS; i++)
+            saved += _regs[i].stats.reads_saved + _regs[i].stats.writes_saved;
+        return saved;
+    }
+
+    void reset_stats(void) {
+        _hw_reads = _hw_writes = 0;
+        for (uint16 i = 0; i < MAX_REGS; i++) {
+            Reg_stats &s = _regs[i].stats;
+            s.hw_reads = s.hw_writes = s.reads_saved = s.writes_saved = 0;
+        }
+    }
+
+private:
+    struct Entry {
+        Reg_stats stats; // stats.addr == 0 marks a free slot
+        uint32 val;
+        bool valid;
+    };
+
+    bool owned(mword addr) const {
+        for (uint8 i = 0; i < 2; i++)
+            if ((addr >= _base[i]) && (addr < _base[i] + _size[i])) return true;
+        return false;
+    }
+
+    bool aliased(mword addr) const {
+        for (uint8 i = 0; i < 2; i++)
+            if ((addr >= _base[i]) && (addr < _base[i] + _size[i])) return _aliased & (1u << i);
+        return false;
+    }
+
+    void update_bits(mword addr, uint32 bits, bool set) {
+        if (!aliased(addr)) {
+            uint32 val = read(addr);
+            write(addr, set ? (val | bits) : (val & ~bits));
+            return;
+        }
+
+        // an unknown register stays unknown, there is no need to read it
+        Entry *e = lookup(addr);
+        if ((e != nullptr) && e->valid) {
+            uint32 val = set ? (e->val | bits) : (e->val & ~bits);
+            if (val == e->val) {
+                e->stats.writes_saved++;
+                return;
+            }
+            e->val = val;
+        }
+        raw_write(addr + (set ? SET_OFFSET : CLR_OFFSET), bits);
+        if (e != nullptr) e->stats.hw_writes++;
+    }
+
+    Entry *lookup(mword addr) {
+        if (!owned(addr)) return nullptr;
+
+        uint16 idx = static_cast<uint16>(((addr >> 2) * 0x9e3779b1u) >> 24) % MAX_REGS;
+        for (uint16 n = 0; n < MAX_REGS; n++, idx = (idx + 1) % MAX_REGS) {
+            Entry &e = _regs[idx];
+            if (e.stats.addr == addr) return &e;
+            if (e.stats.addr == 0) {
+                e.stats.addr = addr;
+                return &e;
+            }
+        }
+        return nullptr; // table full
+    }
+
+    uint32 raw_read(mword addr) {
+        _hw_reads++;
+        return ind(addr);
+    }
+
+    void raw_write(mword addr, uint32 val) {
+        _hw_writes++;
+        outd(addr, val);
+    }
+
+    uint32 load(Entry *e) {
+        e->val = raw_read(e->stats.addr);
+        e->valid = true;
+        e->stats.hw_reads++;
+        return e->val;
+    }
+
+    mword _base[2];
+    mword _size[2];
+    uint8 _aliased;
+    Entry _regs[MAX_REGS];
+    uint64 _hw_reads;
+    uint64 _hw_writes;
+};
+
+extern Imx_regfile imx_regs;
+
+/**
+ * Field updates of one register, collected and then applied with a single write. Fields
+ * set later override earlier ones.
+ */
+class Reg_txn {
+public:
+    explicit Reg_txn(mword addr) : _addr(addr), _mask(0), _val(0) {}
+
+    void set(uint32 mask, uint32 val) {
+        _mask |= mask;
+        _val = (_val & ~mask) | (val & mask);
+    }
+
+    mword addr(void) const { return _addr; }
+    bool empty(void) const { return _mask == 0; }
+
+    /* reg with the fields updated */
+    uint32 apply(uint32 reg) const { return (reg & ~_mask) | _val; }
+
+private:
+    mword _addr;
+    uint32 _mask;
+    uint32 _val;
+};
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <config.hpp>
+#include <drv_ipc.hpp>
+#include <pm.hpp>
+
+/**
+ * Register accesses of the clocks, newest MMIO_TRACE_ENTRIES kept, built with
+ * IMX_MMIO_TRACE only. Every access a clock asks for is recorded, whether the shadow
+ * register file serves it or not, so the report shows what the clock code itself repeats.
+ * Accesses are made under the tree lock, which also serializes the recording.
+ */
+class Mmio_trace {
+public:
+    enum : uint8 {
+        WRITE = (1u << 0),
+        HW = (1u << 1),       // reached the hardware
+        VOLATILE = (1u << 2), // read of status bits, never redundant
+        SET = (1u << 3),      // write of bits to set, through the alias if there is one
+        CLR = (1u << 4),      // write of bits to clear
+    };
+
+    struct Entry {
+        mword addr;
+        uint32 val;
+        uint16 clk;
+        uint8 kind;
+        uint8 flags;
+    };
+
+    constexpr Mmio_trace() : _entries{}, _next(0), _regs{} {}
+
+    void record(mword addr, uint32 val, uint32 clk, uint8 kind, uint8 flags) {
+        Entry &e = _entries[_next++ % MMIO_TRACE_ENTRIES];
+        e.addr = addr;
+        e.val = val;
+        e.clk = static_cast<uint16>(clk);
+        e.kind = kind;
+        e.flags = flags;
+    }
+
+    void clear(void) { _next = 0; }
+
+    /* accesses recorded since the last clear, the oldest may have been overwritten */
+    uint64 recorded(void) const { return _next; }
+
+    /**
+     * Replay the kept accesses and count them per clock kind, recs has room for kinds
+     * records. A register's value is known once it was read or written in the window.
+     */
+    void report(drv_ipc::mmio_stats_rec *recs, uint8 kinds);
+
+private:
+    static constexpr uint16 MAX_REGS = 512;
+
+    struct Known {
+        mword addr; // 0 if the slot is free
+        uint32 val;
+        bool valid;
+        bool written; // val was written, not read
+    };
+
+    Known *known(mword addr);
+
+    Entry _entries[MMIO_TRACE_ENTRIES];
+    uint64 _next;
+    Known _regs[MAX_REGS];
+};
+
+#if IMX_MMIO_TRACE
+extern Mmio_trace mmio_trace;
+#endif
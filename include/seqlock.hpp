@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <pm.hpp>
+#include <timer.hpp>
+
+/**
+ * Value published under a sequence counter. Readers never block a writer, they retry if
+ * they overlapped with an update. The counter is odd while an update is in progress.
+ * Writers must be serialized by the caller.
+ */
+template <typename T>
+class Seq_value {
+public:
+    constexpr Seq_value() : _seq(0), _words{} {}
+
+    void read(T &val) const {
+        uint32 words[WORDS];
+        for (;;) {
+            uint32 seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+            if (seq & 1) {
+                Timer::relax();
+                continue;
+            }
+            for (uint16 i = 0; i < WORDS; i++)
+                words[i] = __atomic_load_n(&_words[i], __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&_seq, __ATOMIC_RELAXED) == seq) break;
+        }
+        __builtin_memcpy(&val, words, sizeof(T));
+    }
+
+    void write(const T &val) {
+        uint32 words[WORDS] = {};
+        __builtin_memcpy(words, &val, sizeof(T));
+
+        uint32 seq = _seq;
+        __atomic_store_n(&_seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (uint16 i = 0; i < WORDS; i++)
+            __atomic_store_n(&_words[i], words[i], __ATOMIC_RELAXED);
+        __atomic_store_n(&_seq, seq + 2, __ATOMIC_RELEASE);
+    }
+
+private:
+    static constexpr uint16 WORDS = (sizeof(T) + sizeof(uint32) - 1) / sizeof(uint32);
+
+    uint32 _seq;
+    uint32 _words[WORDS];
+};
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <pm.hpp>
+#include <timer.hpp>
+
+/* test and test-and-set lock, the critical sections of the driver are a few MMIO accesses long */
+class Spinlock {
+public:
+    constexpr Spinlock() : _locked(false) {}
+
+    bool try_lock(void) { return !__atomic_test_and_set(&_locked, __ATOMIC_ACQUIRE); }
+
+    void lock(void) {
+        while (!try_lock())
+            while (__atomic_load_n(&_locked, __ATOMIC_RELAXED)) Timer::relax();
+    }
+
+    void unlock(void) { __atomic_clear(&_locked, __ATOMIC_RELEASE); }
+
+private:
+    bool _locked;
+};
+
+class Lock_guard {
+public:
+    explicit Lock_guard(Spinlock &lock) : _lock(lock) { _lock.lock(); }
+    ~Lock_guard() { _lock.unlock(); }
+
+    Lock_guard(const Lock_guard &) = delete;
+    Lock_guard &operator=(const Lock_guard &) = delete;
+
+private:
+    Spinlock &_lock;
+};
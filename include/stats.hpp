@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <drv_ipc.hpp>
+#include <pm.hpp>
+#include <timer.hpp>
+
+/**
+ * Call counts and latency histograms of the portal, one set per drv_ipc::method. The
+ * service ECs of all CPUs record concurrently, counters are updated atomically and a
+ * reader may see a call in the count before it shows up in the histogram.
+ */
+class Portal_stats {
+public:
+    constexpr Portal_stats() : _methods{} {}
+
+    void record(uint32 method, uint64 ticks, Errno err) {
+        if (method >= drv_ipc::NUM_METHODS) return;
+
+        drv_ipc::method_stats_rec &m = _methods[method];
+        __atomic_fetch_add(&m.calls, 1, __ATOMIC_RELAXED);
+        if ((err != Errno::ENONE) && (err != Errno::EINPROGRESS))
+            __atomic_fetch_add(&m.errors, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&m.ticks, ticks, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&m.hist[bucket(ticks)], 1, __ATOMIC_RELAXED);
+    }
+
+    /* methods from cursor on, returns the next cursor */
+    uint32 get(uint32 cursor, drv_ipc::method_stats_rec *recs, uint32 max_recs,
+               uint32 &num_recs) const {
+        num_recs = 0;
+        for (; (cursor < drv_ipc::NUM_METHODS) && (num_recs < max_recs); cursor++) {
+            drv_ipc::method_stats_rec &rec = recs[num_recs++];
+            const drv_ipc::method_stats_rec &m = _methods[cursor];
+
+            rec.method = cursor;
+            rec.calls = __atomic_load_n(&m.calls, __ATOMIC_RELAXED);
+            rec.errors = __atomic_load_n(&m.errors, __ATOMIC_RELAXED);
+            rec.reserved = 0;
+            rec.ticks = __atomic_load_n(&m.ticks, __ATOMIC_RELAXED);
+            for (uint8 i = 0; i < drv_ipc::method_stats_rec::BUCKETS; i++)
+                rec.hist[i] = __atomic_load_n(&m.hist[i], __ATOMIC_RELAXED);
+        }
+        return cursor;
+    }
+
+    void reset(void) {
+        for (uint32 i = 0; i < drv_ipc::NUM_METHODS; i++) {
+            drv_ipc::method_stats_rec &m = _methods[i];
+            __atomic_store_n(&m.calls, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m.errors, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&m.ticks, 0, __ATOMIC_RELAXED);
+            for (uint8 b = 0; b < drv_ipc::method_stats_rec::BUCKETS; b++)
+                __atomic_store_n(&m.hist[b], 0, __ATOMIC_RELAXED);
+        }
+    }
+
+private:
+    static uint8 bucket(uint64 ticks) {
+        uint8 b = 0;
+        while ((b < drv_ipc::method_stats_rec::BUCKETS - 1) && (ticks >> b))
+            b++;
+        return b;
+    }
+
+    drv_ipc::method_stats_rec _methods[drv_ipc::NUM_METHODS];
+};
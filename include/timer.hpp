@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#pragma once
+#include <pm.hpp>
+
+/* whether now() counts time, without a generic timer it only counts its calls */
+#if defined(__aarch64__) || defined(PBL_HOST)
+#define TIMER_COUNTS_TIME (1)
+#else
+#define TIMER_COUNTS_TIME (0)
+#endif
+
+/* ARM generic timer, virtual count */
+namespace Timer {
+
+__ALWAYS_INLINE__
+static inline uint64
+now(void) {
+#if defined(__aarch64__)
+    uint64 val;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(val)::"memory");
+    return val;
+#elif defined(PBL_HOST)
+    return Pbl::host_ticks();
+#else
+    static uint64 ticks; // no generic timer, see TIMER_COUNTS_TIME
+    return ++ticks;
+#endif
+}
+
+/* ticks per second */
+__ALWAYS_INLINE__
+static inline uint64
+freq(void) {
+#if defined(__aarch64__)
+    uint64 val;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(val));
+    return val;
+#elif defined(PBL_HOST)
+    return 1000000000;
+#else
+    return 1;
+#endif
+}
+
+/* ticks in a duration of us microseconds, rounded up */
+static inline uint64
+us_to_ticks(uint64 us) {
+    return (us * freq() + 999999) / 1000000;
+}
+
+static inline uint64
+ticks_to_us(uint64 ticks) {
+    return (ticks * 1000000) / freq();
+}
+
+/* hint to the core that we are busy-waiting */
+__ALWAYS_INLINE__
+static inline void
+relax(void) {
+#if defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+}
@@ -6,6 +6,11 @@
 
 #include <imx8mq.hpp>
 
+/* clocks synced at boot in lazy mode, the ones the product needs right away */
+static constexpr uint16 warm_clks[] = {
+    IMX8MQ_CLK_UART1_ROOT,
+};
+
 Errno
 Imx8mq::probe(Pbl::Utcb *utcb, const char *ccm, const char *anatop) {
 
@@ -14,27 +19,156 @@ Imx8mq::probe(Pbl::Utcb *utcb, const char *ccm, const char *anatop) {
     err = Pbl::API::acquire_resource(utcb, anatop, Pbl::API::RES_REG, 0, ANATOP_VA, 0, false);
     if (err != Errno::ENONE) return err;
 
-    return _ccm.probe();
+    err = _ccm.probe(CLK_LAZY_INIT, warm_clks, sizeof(warm_clks) / sizeof(warm_clks[0]));
+    if (err != Errno::ENONE) return err;
+
+    Pll_lock::pause_hook = &_pause;
+    return Errno::ENONE;
+}
+
+/* the domains follow the parents, they are checked again once the locks are held */
+void
+Imx8mq::lock_domains(uint64 clk_id, uint64 other_id, uint8 &lo, uint8 &hi) {
+    for (;;) {
+        {
+            Lock_guard tree(_tree);
+            lo = _ccm.domain_of(clk_id);
+            hi = _ccm.domain_of(other_id);
+        }
+        if (lo > hi) {
+            uint8 tmp = lo;
+            lo = hi;
+            hi = tmp;
+        }
+
+        _domains[lo].lock();
+        if (hi != lo) _domains[hi].lock();
+        _tree.lock();
+        uint8 a = _ccm.domain_of(clk_id), b = _ccm.domain_of(other_id);
+        if (((a == lo) && (b == hi)) || ((a == hi) && (b == lo))) return;
+        unlock_domains(lo, hi);
+    }
+}
+
+void
+Imx8mq::unlock_domains(uint8 lo, uint8 hi) {
+    _tree.unlock();
+    if (hi != lo) _domains[hi].unlock();
+    _domains[lo].unlock();
+}
+
+uint32
+Imx8mq::clk_stats(uint32 cursor, drv_ipc::clk_stats_rec *recs, uint32 max_recs,
+                  uint32 &num_recs) {
+    Lock_guard tree(_tree);
+    return _ccm.clk_stats(cursor, recs, max_recs, num_recs);
+}
+
+void
+Imx8mq::reset_stats(void) {
+    Lock_guard tree(_tree);
+    _ccm.reset_stats();
+}
+
+Errno
+Imx8mq::mmio_stats(uint32 &cursor, drv_ipc::mmio_stats_rec *recs, uint32 max_recs,
+                   uint32 &num_recs) {
+    Lock_guard tree(_tree);
+    return _ccm.mmio_stats(cursor, recs, max_recs, num_recs);
+}
+
+uint32
+Imx8mq::dump(uint32 cursor, drv_ipc::clk_dump_rec *recs, uint32 max_recs, uint32 &num_recs) {
+    return _ccm.dump(cursor, recs, max_recs, num_recs);
+}
+
+void
+Imx8mq::attach_status(drv_ipc::clk_status_page *page) {
+    Lock_guard tree(_tree);
+    _ccm.attach_status(page);
+}
+
+Errno
+Imx8mq::subscribe(const uint16 *ids, uint32 num_ids, mword sem, uint32 &sub_id) {
+    for (uint32 i = 0; i < num_ids; i++)
+        if (!is_clk_valid(ids[i])) return Errno::EINVAL;
+
+    Lock_guard tree(_tree);
+    return _ccm.subscribe(ids, num_ids, sem, sub_id);
+}
+
+Errno
+Imx8mq::unsubscribe(uint32 sub_id) {
+    Lock_guard tree(_tree);
+    return _ccm.unsubscribe(sub_id);
+}
+
+Errno
+Imx8mq::take_changes(uint32 sub_id, uint64 *changed) {
+    Lock_guard tree(_tree);
+    return _ccm.take_changes(sub_id, changed);
+}
+
+bool
+Imx8mq::next_notification(mword &sem) {
+    Lock_guard tree(_tree);
+    return _ccm.next_notification(sem);
 }
 
 Errno
 Imx8mq::enable_clk(uint64 clk_id) {
+    Write_guard guard(*this, clk_id);
     return _ccm.enable_clk(clk_id);
 }
 
 Errno
 Imx8mq::get_clkrate(uint64 clk_id, uint64 &value) {
+    Imx_ClkCtrl::Clk_state state;
+    if (_ccm.read_state(clk_id, state) && (state.flags & Imx_ClkCtrl::Clk_state::RATE)) {
+        value = state.rate;
+        return Errno::ENONE;
+    }
+
+    Lock_guard tree(_tree);
     return _ccm.get_clkrate(clk_id, value);
 }
 
 Errno
 Imx8mq::disable_clk(uint64 clk_id) {
+    Write_guard guard(*this, clk_id);
     return _ccm.disable_clk(clk_id);
 }
 
+/* a clock that solves across its parents also locks the domain of the one it moves to */
 Errno
 Imx8mq::set_clkrate(uint64 clk_id, uint64 value) {
-    return _ccm.set_clkrate(clk_id, value);
+    uint64 parent_id = clk_id;
+    Errno err;
+    {
+        Lock_guard tree(_tree);
+        err = _ccm.rate_parent(clk_id, value, parent_id);
+    }
+    if (err == Errno::ENOTSUP) {
+        Write_guard guard(*this, clk_id);
+        return _ccm.set_clkrate(clk_id, value);
+    }
+    if (err != Errno::ENONE) return err;
+
+    Write_guard guard(*this, clk_id, parent_id);
+    return _ccm.set_clkrate(clk_id, value, parent_id);
+}
+
+Errno
+Imx8mq::configure(uint64 clk_id, uint64 parent_id, uint64 rate, uint32 flags) {
+    bool reparent = flags & drv_ipc::CLK_CONFIG_PARENT;
+    Write_guard guard(*this, clk_id, reparent ? parent_id : clk_id);
+    return _ccm.configure(clk_id, parent_id, rate, flags);
+}
+
+Errno
+Imx8mq::round_clkrate(uint64 clk_id, uint64 value, uint64 &rounded) {
+    Lock_guard tree(_tree);
+    return _ccm.round_clkrate(clk_id, value, rounded);
 }
 
 uint32
@@ -44,6 +178,10 @@ Imx8mq::get_max_clkid(void) {
 
 bool
 Imx8mq::is_clk_enabled(uint64 clk_id) {
+    Imx_ClkCtrl::Clk_state state;
+    if (_ccm.read_state(clk_id, state)) return state.flags & Imx_ClkCtrl::Clk_state::ENABLED;
+
+    Lock_guard tree(_tree);
     return _ccm.is_enabled(clk_id);
 }
 
@@ -57,5 +195,125 @@ Imx8mq::is_clk_valid(uint64 clk_id) {
 
 Errno
 Imx8mq::describe_clkrate(uint64 clk_id, Pm::clk_desc &rate) {
+    Imx_ClkCtrl::Clk_state state;
+    if (_ccm.read_state(clk_id, state) && (state.flags & Imx_ClkCtrl::Clk_state::DESC)) {
+        rate = state.desc;
+        return Errno::ENONE;
+    }
+
+    Lock_guard tree(_tree);
     return _ccm.describe_clkrate(clk_id, rate);
 }
+
+void
+Imx8mq::run_batch(drv_ipc::clk_batch_op *ops, uint32 num_ops) {
+    for (uint32 i = 0; i < num_ops; i++) {
+        drv_ipc::clk_batch_op &op = ops[i];
+
+        if (!is_clk_valid(op.clk_id)) {
+            op.errno = Errno::EINVAL;
+            continue;
+        }
+
+        switch (op.op) {
+        case drv_ipc::method::CLK_ENABLE:
+            op.errno = enable_clk(op.clk_id);
+            break;
+        case drv_ipc::method::CLK_DISABLE:
+            op.errno = disable_clk(op.clk_id);
+            break;
+        case drv_ipc::method::CLK_GET_RATE:
+            op.errno = get_clkrate(op.clk_id, op.value);
+            break;
+        case drv_ipc::method::CLK_SET_RATE:
+            op.errno = set_clkrate(op.clk_id, op.value);
+            break;
+        case drv_ipc::method::CLK_ROUND_RATE:
+            op.errno = round_clkrate(op.clk_id, op.value, op.value);
+            break;
+        case drv_ipc::method::CLK_IS_ENABLED:
+            op.value = is_clk_enabled(op.clk_id) ? 1 : 0;
+            op.errno = Errno::ENONE;
+            break;
+        default:
+            op.errno = Errno::ENOTSUP;
+            break;
+        }
+    }
+}
+
+Errno
+Imx8mq::submit(drv_ipc::method op, uint64 clk_id, uint64 value, mword sem, uint32 &ticket) {
+    if ((op != drv_ipc::method::CLK_ENABLE) && (op != drv_ipc::method::CLK_SET_RATE))
+        return Errno::ENOTSUP;
+
+    Lock_guard guard(_jobs_lock);
+
+    // results nobody collected yet keep their slot, the client may still ask for them
+    Clk_job *job = nullptr;
+    for (uint16 i = 0; i < CLK_ASYNC_JOBS; i++) {
+        if (_jobs[i].state == Clk_job::FREE) {
+            job = &_jobs[i];
+            break;
+        }
+    }
+    if (job == nullptr) return Errno::EBUSY;
+
+    if (++_next_ticket == 0) _next_ticket = 1; // 0 is never handed out
+    job->state = Clk_job::QUEUED;
+    job->op = op;
+    job->ticket = _next_ticket;
+    job->result = Errno::EINPROGRESS;
+    job->clk_id = clk_id;
+    job->value = value;
+    job->sem = sem;
+
+    ticket = job->ticket;
+    return Errno::EINPROGRESS;
+}
+
+Errno
+Imx8mq::async_status(uint32 ticket) {
+    Lock_guard guard(_jobs_lock);
+
+    for (uint16 i = 0; i < CLK_ASYNC_JOBS; i++) {
+        Clk_job &job = _jobs[i];
+        if ((job.state == Clk_job::FREE) || (job.ticket != ticket)) continue;
+        if (job.state != Clk_job::DONE) return Errno::EINPROGRESS;
+        job.state = Clk_job::FREE;
+        return job.result;
+    }
+    return Errno::EINVAL;
+}
+
+/**
+ * Requests run in ticket order. The PLL sequences park between polls of the lock bit and
+ * hand the tree back meanwhile, see Pll_lock::Pause_hook.
+ */
+bool
+Imx8mq::run_job(mword &sem) {
+    Clk_job *job = nullptr;
+    {
+        Lock_guard guard(_jobs_lock);
+        for (uint16 i = 0; i < CLK_ASYNC_JOBS; i++) {
+            Clk_job &j = _jobs[i];
+            if ((j.state == Clk_job::QUEUED)
+                && ((job == nullptr) || (static_cast<int32>(j.ticket - job->ticket) < 0)))
+                job = &j;
+        }
+        if (job == nullptr) return false;
+        job->state = Clk_job::RUNNING;
+    }
+
+    Errno err;
+    if (job->op == drv_ipc::method::CLK_ENABLE)
+        err = enable_clk(job->clk_id);
+    else
+        err = set_clkrate(job->clk_id, job->value);
+
+    Lock_guard guard(_jobs_lock);
+    job->result = err;
+    job->state = Clk_job::DONE;
+    sem = job->sem;
+    return true;
+}
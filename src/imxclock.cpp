@@ -11,1152 +11,1265 @@
 
 #include <imx8mq.hpp>
 #include <imxclock.hpp>
+#include <timer.hpp>
+
+Imx_regfile imx_regs(CCM_VA, CCM_SIZE, ANATOP_VA, ANATOP_SIZE,
+                     CLK_CCM_ALIASES ? Imx_regfile::ALIASED0 : 0);
+Pll_lock::Pause_hook *Pll_lock::pause_hook = nullptr;
+#if CLK_DISPATCH_STATS
+thread_local Clk_ops::Dispatch_stats Clk_ops::dispatch_stats = {};
+#endif
+
+/* Clock tree builders, one per Clk_kind */
+static constexpr Clk_def
+def_fixed(uint16 id, uint32 rate) {
+    return {id, CLK_FIXED, 0, 0, 0, CLOCK_FIXED, rate, 0, {}};
+}
 
-/* Analog Clocks and PLLs */
-Imx_fixed_clock imx_clk_dummy(IMX8MQ_CLK_DUMMY, 0);
-Imx_fixed_clock imx_clk_32k(IMX8MQ_CLK_32K, 32768);
-Imx_fixed_clock imx_clk_25m(IMX8MQ_CLK_25M, 25000000);
-Imx_fixed_clock imx_clk_27m(IMX8MQ_CLK_27M, 27000000);
-Imx_fixed_clock imx_clk_ext1(IMX8MQ_CLK_EXT1, 133000000);
-Imx_fixed_clock imx_clk_ext2(IMX8MQ_CLK_EXT2, 133000000);
-Imx_fixed_clock imx_clk_ext3(IMX8MQ_CLK_EXT3, 133000000);
-Imx_fixed_clock imx_clk_ext4(IMX8MQ_CLK_EXT4, 133000000);
-
-Clock* pll_ref_sels[4] = {&imx_clk_25m, &imx_clk_27m, nullptr, nullptr};
-
-Imx_clock_mux imx_arm_pll_ref_sel(IMX8MQ_ARM_PLL_REF_SEL, (ANATOP_VA + 0x28), 16, 2, pll_ref_sels,
-                                  4);
-Imx_clock_mux imx_gpu_pll_ref_sel(IMX8MQ_GPU_PLL_REF_SEL, (ANATOP_VA + 0x18), 16, 2, pll_ref_sels,
-                                  4);
-Imx_clock_mux imx_vpu_pll_ref_sel(IMX8MQ_VPU_PLL_REF_SEL, (ANATOP_VA + 0x20), 16, 2, pll_ref_sels,
-                                  4);
-Imx_clock_mux imx_audio_pll1_ref_sel(IMX8MQ_AUDIO_PLL1_REF_SEL, (ANATOP_VA + 0x0), 16, 2,
-                                     pll_ref_sels, 4);
-Imx_clock_mux imx_audio_pll2_ref_sel(IMX8MQ_AUDIO_PLL2_REF_SEL, (ANATOP_VA + 0x8), 16, 2,
-                                     pll_ref_sels, 4);
-Imx_clock_mux imx_video_pll1_ref_sel(IMX8MQ_VIDEO_PLL1_REF_SEL, (ANATOP_VA + 0x10), 16, 2,
-                                     pll_ref_sels, 4);
-Imx_clock_mux imx_sys3_pll1_ref_sel(IMX8MQ_SYS3_PLL1_REF_SEL, (ANATOP_VA + 0x48), 0, 2,
-                                    pll_ref_sels, 4);
-Imx_clock_mux imx_dram_pll1_ref_sel(IMX8MQ_DRAM_PLL1_REF_SEL, (ANATOP_VA + 0x60), 0, 2,
-                                    pll_ref_sels, 4);
-Imx_clock_mux imx_video2_pll1_ref_sel(IMX8MQ_VIDEO2_PLL1_REF_SEL, (ANATOP_VA + 0x54), 0, 2,
-                                      pll_ref_sels, 4);
-
-Imx_clock_div imx_arm_pll_ref_div(IMX8MQ_ARM_PLL_REF_DIV, &imx_arm_pll_ref_sel, (ANATOP_VA + 0x28),
-                                  5, 6);
-Imx_clock_div imx_gpu_pll_ref_div(IMX8MQ_GPU_PLL_REF_DIV, &imx_gpu_pll_ref_sel, (ANATOP_VA + 0x18),
-                                  5, 6);
-Imx_clock_div imx_vpu_pll_ref_div(IMX8MQ_VPU_PLL_REF_DIV, &imx_vpu_pll_ref_sel, (ANATOP_VA + 0x20),
-                                  5, 6);
-Imx_clock_div imx_audio_pll1_ref_div(IMX8MQ_AUDIO_PLL1_REF_DIV, &imx_audio_pll1_ref_sel,
-                                     (ANATOP_VA + 0x0), 5, 6);
-Imx_clock_div imx_audio_pll2_ref_div(IMX8MQ_AUDIO_PLL2_REF_DIV, &imx_audio_pll2_ref_sel,
-                                     (ANATOP_VA + 0x8), 5, 6);
-Imx_clock_div imx_video_pll1_ref_div(IMX8MQ_VIDEO_PLL1_REF_DIV, &imx_video_pll1_ref_sel,
-                                     (ANATOP_VA + 0x10), 5, 6);
-
-Frac_pll imx_arm_pll(IMX8MQ_ARM_PLL, &imx_arm_pll_ref_div, (ANATOP_VA + 0x28));
-Frac_pll imx_gpu_pll(IMX8MQ_GPU_PLL, &imx_gpu_pll_ref_div, (ANATOP_VA + 0x18));
-Frac_pll imx_vpu_pll(IMX8MQ_VPU_PLL, &imx_vpu_pll_ref_div, (ANATOP_VA + 0x20));
-Frac_pll imx_audio_pll1(IMX8MQ_AUDIO_PLL1, &imx_audio_pll1_ref_div, (ANATOP_VA + 0x0));
-Frac_pll imx_audio_pll2(IMX8MQ_AUDIO_PLL2, &imx_audio_pll2_ref_div, (ANATOP_VA + 0x8));
-Frac_pll imx_video_pll1(IMX8MQ_VIDEO_PLL1, &imx_video_pll1_ref_div, (ANATOP_VA + 0x10));
-
-/* PLL bypass out */
-Clock* arm_pll_bypass_sels[] = {&imx_arm_pll, &imx_arm_pll_ref_sel};
-Imx_clock_mux imx_arm_pll_bypass(IMX8MQ_ARM_PLL_BYPASS, (ANATOP_VA + 0x28), 14, 1,
-                                 arm_pll_bypass_sels, 2, (CLOCK_CHANGE_RATE_PARENT));
-
-Clock* gpu_pll_bypass_sels[] = {&imx_gpu_pll, &imx_gpu_pll_ref_sel};
-Imx_clock_mux imx_gpu_pll_bypass(IMX8MQ_GPU_PLL_BYPASS, (ANATOP_VA + 0x18), 14, 1,
-                                 gpu_pll_bypass_sels, 2);
-
-Clock* vpu_pll_bypass_sels[] = {&imx_vpu_pll, &imx_vpu_pll_ref_sel};
-Imx_clock_mux imx_vpu_pll_bypass(IMX8MQ_VPU_PLL_BYPASS, (ANATOP_VA + 0x20), 14, 1,
-                                 vpu_pll_bypass_sels, 2);
-
-Clock* audio_pll1_bypass_sels[] = {&imx_audio_pll1, &imx_audio_pll1_ref_sel};
-Imx_clock_mux imx_audio_pll1_bypass(IMX8MQ_AUDIO_PLL1_BYPASS, (ANATOP_VA + 0x0), 14, 1,
-                                    audio_pll1_bypass_sels, 2);
-
-Clock* audio_pll2_bypass_sels[] = {&imx_audio_pll2, &imx_audio_pll2_ref_sel};
-Imx_clock_mux imx_audio_pll2_bypass(IMX8MQ_AUDIO_PLL2_BYPASS, (ANATOP_VA + 0x8), 14, 1,
-                                    audio_pll2_bypass_sels, 2);
-
-Clock* video_pll1_bypass_sels[] = {&imx_video_pll1, &imx_video_pll1_ref_sel};
-Imx_clock_mux imx_video_pll1_bypass(IMX8MQ_VIDEO_PLL1_BYPASS, (ANATOP_VA + 0x10), 14, 1,
-                                    video_pll1_bypass_sels, 2);
-
-/* PLL OUT GATE */
-Imx_clock_gate imx_arm_pll_out(IMX8MQ_ARM_PLL_OUT, &imx_arm_pll_bypass, (ANATOP_VA + 0x28), 21, 1);
-Imx_clock_gate imx_gpu_pll_out(IMX8MQ_GPU_PLL_OUT, &imx_gpu_pll_bypass, (ANATOP_VA + 0x18), 21, 1);
-Imx_clock_gate imx_vpu_pll_out(IMX8MQ_VPU_PLL_OUT, &imx_vpu_pll_bypass, (ANATOP_VA + 0x20), 21, 1);
-Imx_clock_gate imx_audio_pll1_out(IMX8MQ_AUDIO_PLL1_OUT, &imx_audio_pll1_bypass, (ANATOP_VA + 0x0),
-                                  21, 1);
-Imx_clock_gate imx_audio_pll2_out(IMX8MQ_AUDIO_PLL2_OUT, &imx_audio_pll2_bypass, (ANATOP_VA + 0x8),
-                                  21, 1);
-Imx_clock_gate imx_video_pll1_out(IMX8MQ_VIDEO_PLL1_OUT, &imx_video_pll1_bypass, (ANATOP_VA + 0x10),
-                                  21, 1);
-
-Imx_fixed_clock imx_sys1_pll_out(IMX8MQ_SYS1_PLL_OUT, 800000000);
-Imx_fixed_clock imx_sys2_pll_out(IMX8MQ_SYS2_PLL_OUT, 1000000000);
-
-Sccg_pll_clk imx_sys3_pll_out(IMX8MQ_SYS3_PLL_OUT, &imx_sys3_pll1_ref_sel, (ANATOP_VA + 0x48),
-                              true);
-Sccg_pll_clk imx_dram_pll_out(IMX8MQ_DRAM_PLL_OUT, &imx_dram_pll1_ref_sel, (ANATOP_VA + 0x60),
-                              true);
-Sccg_pll_clk imx_video2_pll_out(IMX8MQ_VIDEO2_PLL_OUT, &imx_video2_pll1_ref_sel, (ANATOP_VA + 0x54),
-                                false);
-
-/* SYS PLL1 fixed output */
-Imx_clock_gate imx_sys1_pll_40m_cg(IMX8MQ_SYS1_PLL_40M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30), 9,
-                                   1);
-Imx_clock_gate imx_sys1_pll_80m_cg(IMX8MQ_SYS1_PLL_80M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                   11, 1);
-Imx_clock_gate imx_sys1_pll_100m_cg(IMX8MQ_SYS1_PLL_100M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    13, 1);
-Imx_clock_gate imx_sys1_pll_133m_cg(IMX8MQ_SYS1_PLL_133M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    15, 1);
-Imx_clock_gate imx_sys1_pll_160m_cg(IMX8MQ_SYS1_PLL_160M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    17, 1);
-Imx_clock_gate imx_sys1_pll_200m_cg(IMX8MQ_SYS1_PLL_200M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    19, 1);
-Imx_clock_gate imx_sys1_pll_266m_cg(IMX8MQ_SYS1_PLL_266M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    21, 1);
-Imx_clock_gate imx_sys1_pll_400m_cg(IMX8MQ_SYS1_PLL_400M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    23, 1);
-Imx_clock_gate imx_sys1_pll_800m_cg(IMX8MQ_SYS1_PLL_800M_CG, &imx_sys1_pll_out, (ANATOP_VA + 0x30),
-                                    25, 1);
-
-Imx_fixdiv_clock imx_sys1_pll_40m(IMX8MQ_SYS1_PLL_40M, &imx_sys1_pll_40m_cg, 1, 20);
-Imx_fixdiv_clock imx_sys1_pll_80m(IMX8MQ_SYS1_PLL_80M, &imx_sys1_pll_80m_cg, 1, 10);
-Imx_fixdiv_clock imx_sys1_pll_100m(IMX8MQ_SYS1_PLL_100M, &imx_sys1_pll_100m_cg, 1, 8);
-Imx_fixdiv_clock imx_sys1_pll_133m(IMX8MQ_SYS1_PLL_133M, &imx_sys1_pll_133m_cg, 1, 6);
-Imx_fixdiv_clock imx_sys1_pll_160m(IMX8MQ_SYS1_PLL_160M, &imx_sys1_pll_160m_cg, 1, 5);
-Imx_fixdiv_clock imx_sys1_pll_200m(IMX8MQ_SYS1_PLL_200M, &imx_sys1_pll_200m_cg, 1, 4);
-Imx_fixdiv_clock imx_sys1_pll_266m(IMX8MQ_SYS1_PLL_266M, &imx_sys1_pll_266m_cg, 1, 3);
-Imx_fixdiv_clock imx_sys1_pll_400m(IMX8MQ_SYS1_PLL_400M, &imx_sys1_pll_400m_cg, 1, 2);
-Imx_fixdiv_clock imx_sys1_pll_800m(IMX8MQ_SYS1_PLL_800M, &imx_sys1_pll_800m_cg, 1, 1);
-
-/* SYS PLL2 fixed output */
-Imx_clock_gate imx_sys2_pll_50m_cg(IMX8MQ_SYS2_PLL_50M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c), 9,
-                                   1);
-Imx_clock_gate imx_sys2_pll_100m_cg(IMX8MQ_SYS2_PLL_100M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    11, 1);
-Imx_clock_gate imx_sys2_pll_125m_cg(IMX8MQ_SYS2_PLL_125M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    13, 1);
-Imx_clock_gate imx_sys2_pll_166m_cg(IMX8MQ_SYS2_PLL_166M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    15, 1);
-Imx_clock_gate imx_sys2_pll_200m_cg(IMX8MQ_SYS2_PLL_200M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    17, 1);
-Imx_clock_gate imx_sys2_pll_250m_cg(IMX8MQ_SYS2_PLL_250M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    19, 1);
-Imx_clock_gate imx_sys2_pll_333m_cg(IMX8MQ_SYS2_PLL_333M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    21, 1);
-Imx_clock_gate imx_sys2_pll_500m_cg(IMX8MQ_SYS2_PLL_500M_CG, &imx_sys2_pll_out, (ANATOP_VA + 0x3c),
-                                    23, 1);
-Imx_clock_gate imx_sys2_pll_1000m_cg(IMX8MQ_SYS2_PLL_1000M_CG, &imx_sys2_pll_out,
-                                     (ANATOP_VA + 0x3c), 25, 1);
-
-Imx_fixdiv_clock imx_sys2_pll_50m(IMX8MQ_SYS2_PLL_50M, &imx_sys2_pll_50m_cg, 1, 20);
-Imx_fixdiv_clock imx_sys2_pll_100m(IMX8MQ_SYS2_PLL_100M, &imx_sys2_pll_100m_cg, 1, 10);
-Imx_fixdiv_clock imx_sys2_pll_125m(IMX8MQ_SYS2_PLL_125M, &imx_sys2_pll_125m_cg, 1, 8);
-Imx_fixdiv_clock imx_sys2_pll_166m(IMX8MQ_SYS2_PLL_166M, &imx_sys2_pll_166m_cg, 1, 6);
-Imx_fixdiv_clock imx_sys2_pll_200m(IMX8MQ_SYS2_PLL_200M, &imx_sys2_pll_200m_cg, 1, 5);
-Imx_fixdiv_clock imx_sys2_pll_250m(IMX8MQ_SYS2_PLL_250M, &imx_sys2_pll_250m_cg, 1, 4);
-Imx_fixdiv_clock imx_sys2_pll_333m(IMX8MQ_SYS2_PLL_333M, &imx_sys2_pll_333m_cg, 1, 3);
-Imx_fixdiv_clock imx_sys2_pll_500m(IMX8MQ_SYS2_PLL_500M, &imx_sys2_pll_500m_cg, 1, 2);
-Imx_fixdiv_clock imx_sys2_pll_1000m(IMX8MQ_SYS2_PLL_1000M, &imx_sys2_pll_1000m_cg, 1, 1);
-
-/* CCM Clocks */
-
-/* CORE */
-
-Clock* imx8mq_a53_sels[]
-    = {&imx_clk_25m,       &imx_arm_pll_out,   &imx_sys2_pll_500m,  &imx_sys2_pll_1000m,
-       &imx_sys1_pll_800m, &imx_sys1_pll_400m, &imx_audio_pll1_out, &imx_sys3_pll_out};
-
-Clock* imx8mq_arm_m4_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m,  &imx_sys2_pll_250m,  &imx_sys1_pll_266m,
-    &imx_sys1_pll_800m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_sys3_pll_out,
-};
-
-Clock* imx8mq_vpu_sels[] = {
-    &imx_clk_25m,       &imx_arm_pll_out,   &imx_sys3_pll_out,   &imx_sys2_pll_1000m,
-    &imx_sys1_pll_800m, &imx_sys1_pll_400m, &imx_audio_pll1_out, &imx_vpu_pll_out,
-};
-
-Clock* imx8mq_gpu_core_sels[] = {
-    &imx_clk_25m,        &imx_gpu_pll_out,    &imx_sys1_pll_800m,  &imx_sys3_pll_out,
-    &imx_sys2_pll_1000m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
-};
-
-Clock* imx8mq_gpu_shader_sels[] = {
-    &imx_clk_25m,        &imx_gpu_pll_out,    &imx_sys1_pll_800m,  &imx_sys3_pll_out,
-    &imx_sys2_pll_1000m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
-};
-
-Imx_clock_mux imx_clk_a53_src(IMX8MQ_CLK_A53_SRC, (CCM_VA + 0x8000), 24, 3, imx8mq_a53_sels, 8,
-                              CLOCK_ENABLE_PARENT);
-Imx_clock_mux imx_clk_m4_src(IMX8MQ_CLK_M4_SRC, (CCM_VA + 0x8080), 24, 3, imx8mq_arm_m4_sels, 8,
-                             CLOCK_ENABLE_PARENT);
-Imx_clock_mux imx_clk_vpu_src(IMX8MQ_CLK_VPU_SRC, (CCM_VA + 0x8100), 24, 3, imx8mq_vpu_sels, 8,
-                              CLOCK_ENABLE_PARENT);
-Imx_clock_mux imx_clk_gpu_core_src(IMX8MQ_CLK_GPU_CORE_SRC, (CCM_VA + 0x8180), 24, 3,
-                                   imx8mq_gpu_core_sels, 8, CLOCK_ENABLE_PARENT);
-Imx_clock_mux imx_clk_gpu_shader_src(IMX8MQ_CLK_GPU_SHADER_SRC, (CCM_VA + 0x8200), 24, 3,
-                                     imx8mq_gpu_shader_sels, 8, CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_a53_cg(IMX8MQ_CLK_A53_CG, &imx_clk_a53_src, (CCM_VA + 0x8000), 28, 1,
-                              CLOCK_ENABLE_PARENT); // critical!
-Imx_clock_gate imx_clk_m4_cg(IMX8MQ_CLK_M4_CG, &imx_clk_m4_src, (CCM_VA + 0x8080), 28, 1,
-                             CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_vpu_cg(IMX8MQ_CLK_VPU_CG, &imx_clk_vpu_src, (CCM_VA + 0x8100), 28, 1,
-                              CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpu_core_cg(IMX8MQ_CLK_GPU_CORE_CG, &imx_clk_gpu_core_src, (CCM_VA + 0x8180),
-                                   28, 1, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpu_shader_cg(IMX8MQ_CLK_GPU_SHADER_CG, &imx_clk_gpu_core_src,
-                                     (CCM_VA + 0x8200), 28, 1, CLOCK_ENABLE_PARENT);
-
-Imx_clock_div imx_clk_a53_div(IMX8MQ_CLK_A53_DIV, &imx_clk_a53_cg, (CCM_VA + 0x8000), 0, 3,
-                              CLOCK_ENABLE_PARENT);
-Imx_clock_div imx_clk_m4_div(IMX8MQ_CLK_M4_DIV, &imx_clk_m4_cg, (CCM_VA + 0x8080), 0, 3,
-                             CLOCK_ENABLE_PARENT);
-Imx_clock_div imx_clk_vpu_div(IMX8MQ_CLK_VPU_DIV, &imx_clk_vpu_cg, (CCM_VA + 0x8100), 0, 3,
-                              CLOCK_ENABLE_PARENT);
-Imx_clock_div imx_clk_gpu_core_div(IMX8MQ_CLK_GPU_CORE_DIV, &imx_clk_gpu_core_cg, (CCM_VA + 0x8180),
-                                   0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_div imx_clk_gpu_shader_div(IMX8MQ_CLK_GPU_SHADER_DIV, &imx_clk_gpu_shader_cg,
-                                     (CCM_VA + 0x8200), 0, 3, CLOCK_ENABLE_PARENT);
-
-/* BUS */
-Clock* imx8mq_main_axi_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_333m,  &imx_sys1_pll_800m,  &imx_sys2_pll_250m,
-    &imx_sys2_pll_1000m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_sys1_pll_100m,
-};
+static constexpr Clk_def
+def_fixdiv(uint16 id, uint16 parent, uint32 div) {
+    return {id, CLK_FIXDIV, 0, 0, 1, 0, div, 0, {parent}};
+}
 
-Clock* imx8mq_enet_axi_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_266m,  &imx_sys1_pll_800m,  &imx_sys2_pll_250m,
-    &imx_sys2_pll_200m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_sys3_pll_out,
-};
+template <uint8 N>
+static constexpr Clk_def
+def_mux(uint16 id, mword reg, uint8 shift, uint8 width, const uint16 (&sels)[N], uint16 flags = 0) {
+    Clk_def def = {id, CLK_MUX, shift, width, N, flags, 0, reg, {}};
+    for (uint8 i = 0; i < N; i++)
+        def.parents[i] = sels[i];
+    return def;
+}
 
-Clock* imx8mq_nand_usdhc_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_266m, &imx_sys1_pll_800m, &imx_sys2_pll_200m,
-    &imx_sys1_pll_133m, &imx_sys3_pll_out,  &imx_sys2_pll_250m, &imx_audio_pll1_out,
-};
+static constexpr Clk_def
+def_div(uint16 id, uint16 parent, mword reg, uint8 shift, uint8 width, uint16 flags = 0) {
+    return {id, CLK_DIV, shift, width, 1, flags, 0, reg, {parent}};
+}
 
-Clock* imx8mq_vpu_bus_sels[] = {
-    &imx_clk_25m,      &imx_sys1_pll_800m,  &imx_vpu_pll_out,   &imx_audio_pll2_out,
-    &imx_sys3_pll_out, &imx_sys2_pll_1000m, &imx_sys2_pll_200m, &imx_sys1_pll_100m,
-};
+/* en_val is the value of the enable field, 1 or 3 */
+static constexpr Clk_def
+def_gate(uint16 id, uint16 parent, mword reg, uint8 bit, uint8 en_val, uint16 flags = 0) {
+    uint8 width = (en_val == 1) ? 1 : ((en_val == 3) ? 2 : 0);
+    return {id, CLK_GATE, bit, width, 1, flags, 0, reg, {parent}};
+}
 
-Clock* imx8mq_disp_axi_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_125m,  &imx_sys1_pll_800m, &imx_sys3_pll_out,
-    &imx_sys1_pll_400m, &imx_audio_pll2_out, &imx_clk_ext1,      &imx_clk_ext4,
-};
+static constexpr Clk_def
+def_frac_pll(uint16 id, uint16 parent, mword reg) {
+    return {id, CLK_FRAC_PLL, 0, 0, 1, 0, 0, reg, {parent}};
+}
 
-Clock* imx8mq_disp_apb_sels[] = {
-    &imx_clk_25m,      &imx_sys2_pll_125m,  &imx_sys1_pll_800m, &imx_sys3_pll_out,
-    &imx_sys1_pll_40m, &imx_audio_pll2_out, &imx_clk_ext1,      &imx_clk_ext3,
-};
+static constexpr Clk_def
+def_sccg_pll(uint16 id, uint16 parent, mword reg, bool critical) {
+    uint16 flags = critical ? static_cast<uint16>(CLOCK_CRITICAL) : 0;
+    return {id, CLK_SCCG_PLL, 0, 0, 1, flags, 0, reg, {parent}};
+}
+
+template <uint8 N>
+static constexpr Clk_def
+def_ccm(uint16 id, const uint16 (&sels)[N], mword reg, bool critical = false) {
+    uint16 flags = critical ? static_cast<uint16>(CLOCK_CRITICAL) : 0;
+    Clk_def def = {id, CLK_CCM, 0, 0, N, flags, 0, reg, {}};
+    for (uint8 i = 0; i < N; i++)
+        def.parents[i] = sels[i];
+    return def;
+}
+
+/* audio and pixel clocks, a set_rate picks the running parent that gets closest */
+template <uint8 N>
+static constexpr Clk_def
+def_ccm_any_parent(uint16 id, const uint16 (&sels)[N], mword reg) {
+    Clk_def def = def_ccm(id, sels, reg);
+    def.flags = static_cast<uint16>(def.flags | CLOCK_CHANGE_RATE_PARENT);
+    return def;
+}
 
-Clock* imx8mq_disp_rtrm_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_800m,  &imx_sys2_pll_200m, &imx_sys1_pll_400m,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_clk_ext2,      &imx_clk_ext3,
+/* parent selections by clock id, the index is the value of the mux field */
+static constexpr uint16 pll_ref_sels[] = {IMX8MQ_CLK_25M, IMX8MQ_CLK_27M};
+
+static constexpr uint16 arm_pll_bypass_sels[] = {IMX8MQ_ARM_PLL, IMX8MQ_ARM_PLL_REF_SEL};
+
+static constexpr uint16 gpu_pll_bypass_sels[] = {IMX8MQ_GPU_PLL, IMX8MQ_GPU_PLL_REF_SEL};
+
+static constexpr uint16 vpu_pll_bypass_sels[] = {IMX8MQ_VPU_PLL, IMX8MQ_VPU_PLL_REF_SEL};
+
+static constexpr uint16 audio_pll1_bypass_sels[] = {IMX8MQ_AUDIO_PLL1, IMX8MQ_AUDIO_PLL1_REF_SEL};
+
+static constexpr uint16 audio_pll2_bypass_sels[] = {IMX8MQ_AUDIO_PLL2, IMX8MQ_AUDIO_PLL2_REF_SEL};
+
+static constexpr uint16 video_pll1_bypass_sels[] = {IMX8MQ_VIDEO_PLL1, IMX8MQ_VIDEO_PLL1_REF_SEL};
+
+static constexpr uint16 imx8mq_a53_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_ARM_PLL_OUT, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_SYS3_PLL_OUT,
 };
 
-Clock* imx8mq_usb_bus_sels[] = {
-    &imx_clk_25m,       &imx_sys3_pll_out, &imx_sys1_pll_800m, &imx_sys2_pll_100m,
-    &imx_sys2_pll_200m, &imx_clk_ext2,     &imx_clk_ext4,      &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_arm_m4_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS1_PLL_266M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_SYS3_PLL_OUT,
 };
 
-Clock* imx8mq_gpu_axi_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_800m,  &imx_gpu_pll_out,    &imx_sys3_pll_out,
-    &imx_sys2_pll_1000m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_vpu_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_ARM_PLL_OUT, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VPU_PLL_OUT,
 };
 
-Clock* imx8mq_gpu_ahb_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_800m,  &imx_gpu_pll_out,    &imx_sys3_pll_out,
-    &imx_sys2_pll_1000m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_gpu_core_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_GPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_noc_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_800m,  &imx_sys3_pll_out,   &imx_sys2_pll_1000m,
-    &imx_sys2_pll_500m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_gpu_shader_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_GPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_noc_apb_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_400m, &imx_sys3_pll_out,   &imx_sys2_pll_333m,
-    &imx_sys2_pll_200m, &imx_sys1_pll_800m, &imx_audio_pll1_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_main_axi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_333M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_250M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_SYS1_PLL_100M,
 };
 
-Imx_ccm_clk imx_clk_main_axi(IMX8MQ_CLK_MAIN_AXI, imx8mq_main_axi_sels, (CCM_VA + 0x8800), true);
-Imx_ccm_clk imx_clk_enet_axi(IMX8MQ_CLK_ENET_AXI, imx8mq_enet_axi_sels, (CCM_VA + 0x8880));
-Imx_ccm_clk imx_clk_nand_usdhc_bus(IMX8MQ_CLK_NAND_USDHC_BUS, imx8mq_nand_usdhc_sels,
-                                   (CCM_VA + 0x8900));
-Imx_ccm_clk imx_clk_vpu_bus(IMX8MQ_CLK_VPU_BUS, imx8mq_vpu_bus_sels, (CCM_VA + 0x8980));
-Imx_ccm_clk imx_clk_disp_axi(IMX8MQ_CLK_DISP_AXI, imx8mq_disp_axi_sels, (CCM_VA + 0x8a00));
-Imx_ccm_clk imx_clk_disp_apb(IMX8MQ_CLK_DISP_APB, imx8mq_disp_apb_sels, (CCM_VA + 0x8a80));
-Imx_ccm_clk imx_clk_disp_rtrm(IMX8MQ_CLK_DISP_RTRM, imx8mq_disp_rtrm_sels, (CCM_VA + 0x8b00));
-Imx_ccm_clk imx_clk_usb_bus(IMX8MQ_CLK_USB_BUS, imx8mq_usb_bus_sels, (CCM_VA + 0x8b80));
-Imx_ccm_clk imx_clk_gpu_axi(IMX8MQ_CLK_GPU_AXI, imx8mq_gpu_axi_sels, (CCM_VA + 0x8c00));
-Imx_ccm_clk imx_clk_gpu_ahb(IMX8MQ_CLK_GPU_AHB, imx8mq_gpu_ahb_sels, (CCM_VA + 0x8c80));
-Imx_ccm_clk imx_clk_noc(IMX8MQ_CLK_NOC, imx8mq_noc_sels, (CCM_VA + 0x8d00), true);
-Imx_ccm_clk imx_clk_noc_apb(IMX8MQ_CLK_NOC_APB, imx8mq_noc_apb_sels, (CCM_VA + 0x8d80), true);
+static constexpr uint16 imx8mq_enet_axi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_250M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_SYS3_PLL_OUT,
+};
 
-/* AHB */
-Clock* imx8mq_ahb_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_133m, &imx_sys1_pll_800m,  &imx_sys1_pll_400m,
-    &imx_sys2_pll_125m, &imx_sys3_pll_out,  &imx_audio_pll1_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_nand_usdhc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_200M,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_AUDIO_PLL1_OUT,
 };
 
-Clock* imx8mq_audio_ahb_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_500m, &imx_sys1_pll_800m,  &imx_sys2_pll_1000m,
-    &imx_sys2_pll_166m, &imx_sys3_pll_out,  &imx_audio_pll1_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_vpu_bus_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_100M,
 };
 
-/* AHB clock is used by the AHB bus therefore marked as critical */
-Imx_ccm_clk imx_clk_ahb(IMX8MQ_CLK_AHB, imx8mq_ahb_sels, (CCM_VA + 0x9000), true);
-Imx_ccm_clk imx_clk_audio_ahb(IMX8MQ_CLK_AUDIO_AHB, imx8mq_audio_ahb_sels, (CCM_VA + 0x9100));
+static constexpr uint16 imx8mq_disp_axi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS1_PLL_400M, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT4,
+};
 
-/* IPG */
-Imx_clock_div imx_clk_ipg_root(IMX8MQ_CLK_IPG_ROOT, &imx_clk_ahb, (CCM_VA + 0x9080), 0, 1,
-                               CLOCK_ENABLE_PARENT);
-Imx_clock_div imx_clk_ipg_audio_root(IMX8MQ_CLK_IPG_AUDIO_ROOT, &imx_clk_audio_ahb,
-                                     (CCM_VA + 0x9180), 0, 1, CLOCK_ENABLE_PARENT);
+static constexpr uint16 imx8mq_disp_apb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS1_PLL_40M, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT3,
+};
 
-Clock* imx8mq_dram_alt_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_800m, &imx_sys1_pll_100m,  &imx_sys2_pll_500m,
-    &imx_sys2_pll_250m, &imx_sys1_pll_400m, &imx_audio_pll1_out, &imx_sys1_pll_266m,
+static constexpr uint16 imx8mq_disp_rtrm_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_400M,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3,
 };
 
-Clock* imx8mq_dram_apb_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys1_pll_40m,  &imx_sys1_pll_160m,
-    &imx_sys1_pll_800m, &imx_sys3_pll_out,  &imx_sys2_pll_250m, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_usb_bus_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT4, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Imx_ccm_clk imx_clk_dram_alt(IMX8MQ_CLK_DRAM_ALT, imx8mq_dram_alt_sels, (CCM_VA + 0xa000));
-Imx_ccm_clk imx_clk_dram_apb(IMX8MQ_CLK_DRAM_APB, imx8mq_dram_apb_sels, (CCM_VA + 0xa080), true);
-Imx_fixdiv_clock imx_clk_dram_alt_root(IMX8MQ_CLK_DRAM_ALT_ROOT, &imx_clk_dram_alt, 1, 4);
+static constexpr uint16 imx8mq_gpu_axi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_GPU_PLL_OUT, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Clock* imx8mq_dram_core_sels[] = {&imx_dram_pll_out, &imx_clk_dram_alt_root};
+static constexpr uint16 imx8mq_gpu_ahb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_GPU_PLL_OUT, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Imx_clock_mux imx_clk_dram_core(IMX8MQ_CLK_DRAM_CORE, (CCM_VA + 0x9800), 24, 1,
-                                imx8mq_dram_core_sels, 2,
-                                CLOCK_ENABLE_PARENT); // critical!
+static constexpr uint16 imx8mq_noc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS2_PLL_500M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Clock* imx8mq_vpu_g1_sels[] = {
-    &imx_clk_25m,       &imx_vpu_pll_out,   &imx_sys1_pll_800m, &imx_sys2_pll_1000m,
-    &imx_sys1_pll_100m, &imx_sys2_pll_125m, &imx_sys3_pll_out,  &imx_audio_pll1_out,
+static constexpr uint16 imx8mq_noc_apb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_333M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_vpu_g2_sels[] = {
-    &imx_clk_25m,       &imx_vpu_pll_out,   &imx_sys1_pll_800m, &imx_sys2_pll_1000m,
-    &imx_sys1_pll_100m, &imx_sys2_pll_125m, &imx_sys3_pll_out,  &imx_audio_pll1_out,
+static constexpr uint16 imx8mq_ahb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_133M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS1_PLL_400M,
+    IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Imx_ccm_clk imx_clk_vpu_g1(IMX8MQ_CLK_VPU_G1, imx8mq_vpu_g1_sels, (CCM_VA + 0xa100));
-Imx_ccm_clk imx_clk_vpu_g2(IMX8MQ_CLK_VPU_G2, imx8mq_vpu_g2_sels, (CCM_VA + 0xa180));
+static constexpr uint16 imx8mq_audio_ahb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS2_PLL_166M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+};
 
-Clock* imx8mq_disp_dtrc_sels[] = {
-    &imx_clk_25m,       &imx_vpu_pll_out,   &imx_sys1_pll_800m, &imx_sys2_pll_1000m,
-    &imx_sys1_pll_160m, &imx_sys2_pll_100m, &imx_sys3_pll_out,  &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_dram_alt_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS2_PLL_500M,
+    IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_SYS1_PLL_266M,
 };
 
-Clock* imx8mq_disp_dc8000_sels[] = {
-    &imx_clk_25m,       &imx_vpu_pll_out,   &imx_sys1_pll_800m, &imx_sys2_pll_1000m,
-    &imx_sys1_pll_160m, &imx_sys2_pll_100m, &imx_sys3_pll_out,  &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_dram_apb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS1_PLL_160M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Imx_ccm_clk imx_clk_disp_dtrc(IMX8MQ_CLK_DISP_DTRC, imx8mq_disp_dtrc_sels, (CCM_VA + 0xa200));
-Imx_ccm_clk imx_clk_disp_dc8000(IMX8MQ_CLK_DISP_DC8000, imx8mq_disp_dc8000_sels, (CCM_VA + 0xa280));
+static constexpr uint16 imx8mq_dram_core_sels[] = {IMX8MQ_DRAM_PLL_OUT, IMX8MQ_CLK_DRAM_ALT_ROOT};
 
-Clock* imx8mq_pcie1_ctrl_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_250m, &imx_sys2_pll_200m, &imx_sys1_pll_266m,
-    &imx_sys1_pll_800m, &imx_sys2_pll_500m, &imx_sys2_pll_250m, &imx_sys3_pll_out,
+static constexpr uint16 imx8mq_vpu_g1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL1_OUT,
 };
 
-Clock* imx8mq_pcie1_phy_sels[] = {
-    &imx_clk_25m,  &imx_sys2_pll_100m, &imx_sys2_pll_500m, &imx_clk_ext1,
-    &imx_clk_ext2, &imx_clk_ext3,      &imx_clk_ext4,
+static constexpr uint16 imx8mq_vpu_g2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL1_OUT,
 };
 
-Clock* imx8mq_pcie1_aux_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys2_pll_500m, &imx_sys3_pll_out,
-    &imx_sys2_pll_100m, &imx_sys1_pll_80m,  &imx_sys1_pll_160m, &imx_sys1_pll_200m,
+static constexpr uint16 imx8mq_disp_dtrc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Imx_ccm_clk imx_clk_pcie1_ctrl(IMX8MQ_CLK_PCIE1_CTRL, imx8mq_pcie1_ctrl_sels, (CCM_VA + 0xa300));
-Imx_ccm_clk imx_clk_pcie1_phy(IMX8MQ_CLK_PCIE1_PHY, imx8mq_pcie1_phy_sels, (CCM_VA + 0xa380));
-Imx_ccm_clk imx_clk_pcie1_aux(IMX8MQ_CLK_PCIE1_AUX, imx8mq_pcie1_aux_sels, (CCM_VA + 0xa400));
-
-Clock* imx8mq_dc_pixel_sels[] = {
-    &imx_clk_25m,       &imx_video_pll1_out, &imx_audio_pll2_out, &imx_audio_pll1_out,
-    &imx_sys1_pll_800m, &imx_sys2_pll_1000m, &imx_sys3_pll_out,   &imx_clk_ext4,
+static constexpr uint16 imx8mq_disp_dc8000_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M,
+    IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_lcdif_pixel_sels[] = {
-    &imx_clk_25m,       &imx_video_pll1_out, &imx_audio_pll2_out, &imx_audio_pll1_out,
-    &imx_sys1_pll_800m, &imx_sys2_pll_1000m, &imx_sys3_pll_out,   &imx_clk_ext4,
+static constexpr uint16 imx8mq_pcie1_ctrl_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_266M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS3_PLL_OUT,
 };
 
-Imx_ccm_clk imx_clk_dc_pixel(IMX8MQ_CLK_DC_PIXEL, imx8mq_dc_pixel_sels, (CCM_VA + 0xa480));
-Imx_ccm_clk imx_clk_lcdif_pixel(IMX8MQ_CLK_LCDIF_PIXEL, imx8mq_lcdif_pixel_sels, (CCM_VA + 0xa500));
-
-Clock* imx8mq_sai1_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext1,       &imx_clk_ext2,
+static constexpr uint16 imx8mq_pcie1_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT2,
+    IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4,
 };
 
-Clock* imx8mq_sai2_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext2,       &imx_clk_ext3,
+static constexpr uint16 imx8mq_pcie1_aux_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_200M,
 };
 
-Clock* imx8mq_sai3_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext3,       &imx_clk_ext4,
+static constexpr uint16 imx8mq_dc_pixel_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_AUDIO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT4,
 };
 
-Clock* imx8mq_sai4_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext1,       &imx_clk_ext2,
+static constexpr uint16 imx8mq_lcdif_pixel_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_AUDIO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT4,
 };
 
-Clock* imx8mq_sai5_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext2,       &imx_clk_ext3,
+static constexpr uint16 imx8mq_sai1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT2,
 };
 
-Clock* imx8mq_sai6_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext3,       &imx_clk_ext4,
+static constexpr uint16 imx8mq_sai2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3,
 };
 
-Imx_ccm_clk imx_clk_sai1(IMX8MQ_CLK_SAI1, imx8mq_sai1_sels, (CCM_VA + 0xa580));
-Imx_ccm_clk imx_clk_sai2(IMX8MQ_CLK_SAI2, imx8mq_sai2_sels, (CCM_VA + 0xa600));
-Imx_ccm_clk imx_clk_sai3(IMX8MQ_CLK_SAI3, imx8mq_sai3_sels, (CCM_VA + 0xa680));
-Imx_ccm_clk imx_clk_sai4(IMX8MQ_CLK_SAI4, imx8mq_sai4_sels, (CCM_VA + 0xa700));
-Imx_ccm_clk imx_clk_sai5(IMX8MQ_CLK_SAI5, imx8mq_sai5_sels, (CCM_VA + 0xa780));
-Imx_ccm_clk imx_clk_sai6(IMX8MQ_CLK_SAI6, imx8mq_sai6_sels, (CCM_VA + 0xa800));
+static constexpr uint16 imx8mq_sai3_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4,
+};
 
-Clock* imx8mq_spdif1_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext2,       &imx_clk_ext3,
+static constexpr uint16 imx8mq_sai4_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT2,
 };
 
-Clock* imx8mq_spdif2_sels[] = {
-    &imx_clk_25m,       &imx_audio_pll1_out, &imx_audio_pll2_out, &imx_video_pll1_out,
-    &imx_sys1_pll_133m, &imx_clk_27m,        &imx_clk_ext3,       &imx_clk_ext4,
+static constexpr uint16 imx8mq_sai5_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3,
 };
 
-Imx_ccm_clk imx_clk_spdif1(IMX8MQ_CLK_SPDIF1, imx8mq_spdif1_sels, (CCM_VA + 0xa880));
-Imx_ccm_clk imx_clk_spdif2(IMX8MQ_CLK_SPDIF2, imx8mq_spdif2_sels, (CCM_VA + 0xa900));
+static constexpr uint16 imx8mq_sai6_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4,
+};
 
-Clock* imx8mq_enet_ref_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_125m,  &imx_sys2_pll_500m,  &imx_sys2_pll_100m,
-    &imx_sys1_pll_160m, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_clk_ext4,
+static constexpr uint16 imx8mq_spdif1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3,
 };
 
-Clock* imx8mq_enet_timer_sels[] = {
-    &imx_clk_25m,  &imx_sys2_pll_100m, &imx_audio_pll1_out, &imx_clk_ext1,
-    &imx_clk_ext2, &imx_clk_ext3,      &imx_clk_ext4,       &imx_video_pll1_out,
+static constexpr uint16 imx8mq_spdif2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
+    IMX8MQ_SYS1_PLL_133M, IMX8MQ_CLK_27M, IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4,
 };
 
-Clock* imx8mq_enet_phy_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_50m,   &imx_sys2_pll_125m,  &imx_sys2_pll_500m,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_enet_ref_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS1_PLL_160M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_CLK_EXT4,
 };
-Imx_ccm_clk imx_clk_enet_ref(IMX8MQ_CLK_ENET_REF, imx8mq_enet_ref_sels, (CCM_VA + 0xa980));
-Imx_ccm_clk imx_clk_enet_timer(IMX8MQ_CLK_ENET_TIMER, imx8mq_enet_timer_sels, (CCM_VA + 0xaa00));
-Imx_ccm_clk imx_clk_enet_phy_ref(IMX8MQ_CLK_ENET_PHY_REF, imx8mq_enet_phy_sels, (CCM_VA + 0xaa80));
 
-Clock* imx8mq_nand_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_500m, &imx_audio_pll1_out, &imx_sys1_pll_400m,
-    &imx_audio_pll2_out, &imx_sys3_pll_out,  &imx_sys2_pll_250m,  &imx_video_pll1_out,
+static constexpr uint16 imx8mq_enet_timer_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT2,
+    IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_qspi_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_400m, &imx_sys1_pll_800m, &imx_sys2_pll_500m,
-    &imx_audio_pll2_out, &imx_sys1_pll_266m, &imx_sys3_pll_out,  &imx_sys1_pll_100m,
+static constexpr uint16 imx8mq_enet_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_500M,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT,
 };
-Imx_ccm_clk imx_clk_nand(IMX8MQ_CLK_NAND, imx8mq_nand_sels, (CCM_VA + 0xab00));
-Imx_ccm_clk imx_clk_qspi(IMX8MQ_CLK_QSPI, imx8mq_qspi_sels, (CCM_VA + 0xab80));
 
-Clock* imx8mq_usdhc1_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_400m, &imx_sys1_pll_800m, &imx_sys2_pll_500m,
-    &imx_audio_pll2_out, &imx_sys1_pll_266m, &imx_sys3_pll_out,  &imx_sys1_pll_100m,
+static constexpr uint16 imx8mq_nand_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_SYS1_PLL_400M,
+    IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_usdhc2_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_400m, &imx_sys1_pll_800m, &imx_sys2_pll_500m,
-    &imx_audio_pll2_out, &imx_sys1_pll_266m, &imx_sys3_pll_out,  &imx_sys1_pll_100m,
+static constexpr uint16 imx8mq_qspi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_500M,
+    IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS1_PLL_100M,
 };
-Imx_ccm_clk imx_clk_usdhc1(IMX8MQ_CLK_USDHC1, imx8mq_usdhc1_sels, (CCM_VA + 0xac00));
-Imx_ccm_clk imx_clk_usdhc2(IMX8MQ_CLK_USDHC2, imx8mq_usdhc2_sels, (CCM_VA + 0xac80));
 
-Clock* imx8mq_i2c1_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_160m,  &imx_sys2_pll_50m,   &imx_sys3_pll_out,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out, &imx_sys1_pll_133m,
+static constexpr uint16 imx8mq_usdhc1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_500M,
+    IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS1_PLL_100M,
 };
 
-Clock* imx8mq_i2c2_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_160m,  &imx_sys2_pll_50m,   &imx_sys3_pll_out,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out, &imx_sys1_pll_133m,
+static constexpr uint16 imx8mq_usdhc2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_500M,
+    IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS1_PLL_100M,
 };
 
-Clock* imx8mq_i2c3_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_160m,  &imx_sys2_pll_50m,   &imx_sys3_pll_out,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out, &imx_sys1_pll_133m,
+static constexpr uint16 imx8mq_i2c1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_133M,
 };
 
-Clock* imx8mq_i2c4_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_160m,  &imx_sys2_pll_50m,   &imx_sys3_pll_out,
-    &imx_audio_pll1_out, &imx_video_pll1_out, &imx_audio_pll2_out, &imx_sys1_pll_133m,
+static constexpr uint16 imx8mq_i2c2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_133M,
 };
-Imx_ccm_clk imx_clk_i2c1(IMX8MQ_CLK_I2C1, imx8mq_i2c1_sels, (CCM_VA + 0xad00));
-Imx_ccm_clk imx_clk_i2c2(IMX8MQ_CLK_I2C2, imx8mq_i2c2_sels, (CCM_VA + 0xad80));
-Imx_ccm_clk imx_clk_i2c3(IMX8MQ_CLK_I2C3, imx8mq_i2c3_sels, (CCM_VA + 0xae00));
-Imx_ccm_clk imx_clk_i2c4(IMX8MQ_CLK_I2C4, imx8mq_i2c4_sels, (CCM_VA + 0xae80));
 
-Clock* imx8mq_uart1_sels[] = {
-    &imx_clk_25m,      &imx_sys1_pll_80m, &imx_sys2_pll_200m, &imx_sys2_pll_100m,
-    &imx_sys3_pll_out, &imx_clk_ext2,     &imx_clk_ext4,      &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_i2c3_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_133M,
 };
 
-Clock* imx8mq_uart2_sels[] = {
-    &imx_clk_25m,      &imx_sys1_pll_80m, &imx_sys2_pll_200m, &imx_sys2_pll_100m,
-    &imx_sys3_pll_out, &imx_clk_ext2,     &imx_clk_ext3,      &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_i2c4_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS1_PLL_133M,
 };
 
-Clock* imx8mq_uart3_sels[] = {
-    &imx_clk_25m,      &imx_sys1_pll_80m, &imx_sys2_pll_200m, &imx_sys2_pll_100m,
-    &imx_sys3_pll_out, &imx_clk_ext2,     &imx_clk_ext4,      &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_uart1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT4, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_uart4_sels[] = {
-    &imx_clk_25m,      &imx_sys1_pll_80m, &imx_sys2_pll_200m, &imx_sys2_pll_100m,
-    &imx_sys3_pll_out, &imx_clk_ext2,     &imx_clk_ext3,      &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_uart2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
 };
-Imx_ccm_clk imx_clk_uart1(IMX8MQ_CLK_UART1, imx8mq_uart1_sels, (CCM_VA + 0xaf00));
-Imx_ccm_clk imx_clk_uart2(IMX8MQ_CLK_UART2, imx8mq_uart2_sels, (CCM_VA + 0xaf80));
-Imx_ccm_clk imx_clk_uart3(IMX8MQ_CLK_UART3, imx8mq_uart3_sels, (CCM_VA + 0xb000));
-Imx_ccm_clk imx_clk_uart4(IMX8MQ_CLK_UART4, imx8mq_uart4_sels, (CCM_VA + 0xb080));
 
-Clock* imx8mq_usb_core_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_100m, &imx_sys1_pll_40m, &imx_sys2_pll_100m,
-    &imx_sys2_pll_200m, &imx_clk_ext2,      &imx_clk_ext3,     &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_uart3_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT4, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_usb_phy_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_100m, &imx_sys1_pll_40m, &imx_sys2_pll_100m,
-    &imx_sys2_pll_200m, &imx_clk_ext2,      &imx_clk_ext3,     &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_uart4_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Imx_ccm_clk imx_clk_usb_core_ref(IMX8MQ_CLK_USB_CORE_REF, imx8mq_usb_core_sels, (CCM_VA + 0xb100));
-Imx_ccm_clk imx_clk_usb_phy_ref(IMX8MQ_CLK_USB_PHY_REF, imx8mq_usb_phy_sels, (CCM_VA + 0xb180));
+static constexpr uint16 imx8mq_usb_core_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Clock* imx8mq_gic_sels[]
-    = {&imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys1_pll_40m, &imx_sys2_pll_100m,
-       &imx_sys2_pll_200m, &imx_clk_ext2,      &imx_clk_ext3,     &imx_audio_pll2_out};
+static constexpr uint16 imx8mq_usb_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Imx_ccm_clk imx_clk_gic(IMX8MQ_CLK_GIC, imx8mq_gic_sels, (CCM_VA + 0xb200), true);
+static constexpr uint16 imx8mq_gic_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS2_PLL_100M,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_CLK_EXT2, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Clock* imx8mq_ecspi1_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys1_pll_40m,  &imx_sys1_pll_160m,
-    &imx_sys1_pll_800m, &imx_sys3_pll_out,  &imx_sys2_pll_250m, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_ecspi1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS1_PLL_160M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_ecspi2_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys1_pll_40m,  &imx_sys1_pll_160m,
-    &imx_sys1_pll_800m, &imx_sys3_pll_out,  &imx_sys2_pll_250m, &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_ecspi2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS1_PLL_160M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_AUDIO_PLL2_OUT,
 };
-Imx_ccm_clk imx_clk_ecspi1(IMX8MQ_CLK_ECSPI1, imx8mq_ecspi1_sels, (CCM_VA + 0xb280));
-Imx_ccm_clk imx_clk_ecspi2(IMX8MQ_CLK_ECSPI2, imx8mq_ecspi2_sels, (CCM_VA + 0xb300));
 
-Clock* imx8mq_pwm1_sels[] = {
-    &imx_clk_25m,      &imx_sys2_pll_100m, &imx_sys1_pll_160m, &imx_sys1_pll_40m,
-    &imx_sys3_pll_out, &imx_clk_ext1,      &imx_sys1_pll_80m,  &imx_video_pll1_out,
+static constexpr uint16 imx8mq_pwm1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_40M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT1, IMX8MQ_SYS1_PLL_80M, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_pwm2_sels[] = {
-    &imx_clk_25m,      &imx_sys2_pll_100m, &imx_sys1_pll_160m, &imx_sys1_pll_40m,
-    &imx_sys3_pll_out, &imx_clk_ext1,      &imx_sys1_pll_80m,  &imx_video_pll1_out,
+static constexpr uint16 imx8mq_pwm2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_40M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT1, IMX8MQ_SYS1_PLL_80M, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_pwm3_sels[] = {
-    &imx_clk_25m,      &imx_sys2_pll_100m, &imx_sys1_pll_160m, &imx_sys1_pll_40m,
-    &imx_sys3_pll_out, &imx_clk_ext2,      &imx_sys1_pll_80m,  &imx_video_pll1_out,
+static constexpr uint16 imx8mq_pwm3_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_40M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_SYS1_PLL_80M, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_pwm4_sels[] = {
-    &imx_clk_25m,      &imx_sys2_pll_100m, &imx_sys1_pll_160m, &imx_sys1_pll_40m,
-    &imx_sys3_pll_out, &imx_clk_ext2,      &imx_sys1_pll_80m,  &imx_video_pll1_out,
+static constexpr uint16 imx8mq_pwm4_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_40M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT2, IMX8MQ_SYS1_PLL_80M, IMX8MQ_VIDEO_PLL1_OUT,
 };
-Imx_ccm_clk imx_clk_pwm1(IMX8MQ_CLK_PWM1, imx8mq_pwm1_sels, (CCM_VA + 0xb380));
-Imx_ccm_clk imx_clk_pwm2(IMX8MQ_CLK_PWM2, imx8mq_pwm2_sels, (CCM_VA + 0xb400));
-Imx_ccm_clk imx_clk_pwm3(IMX8MQ_CLK_PWM3, imx8mq_pwm3_sels, (CCM_VA + 0xb480));
-Imx_ccm_clk imx_clk_pwm4(IMX8MQ_CLK_PWM4, imx8mq_pwm4_sels, (CCM_VA + 0xb500));
 
-Clock* imx8mq_gpt1_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_100m, &imx_sys1_pll_400m,  &imx_sys1_pll_40m,
-    &imx_video_pll1_out, &imx_sys1_pll_80m,  &imx_audio_pll1_out, &imx_clk_ext1,
+static constexpr uint16 imx8mq_gpt1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS1_PLL_40M,
+    IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_SYS1_PLL_80M, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_CLK_EXT1,
 };
 
-Clock* imx8mq_wdog_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_133m, &imx_sys1_pll_160m, &imx_vpu_pll_out,
-    &imx_sys2_pll_125m, &imx_sys3_pll_out,  &imx_sys1_pll_80m,  &imx_sys2_pll_166m,
+static constexpr uint16 imx8mq_wdog_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_133M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_VPU_PLL_OUT,
+    IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS2_PLL_166M,
 };
 
-Clock* imx8mq_wrclk_sels[] = {
-    &imx_clk_25m,       &imx_sys1_pll_40m,  &imx_vpu_pll_out,   &imx_sys3_pll_out,
-    &imx_sys2_pll_200m, &imx_sys1_pll_266m, &imx_sys2_pll_500m, &imx_sys1_pll_100m,
+static constexpr uint16 imx8mq_wrclk_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS1_PLL_100M,
 };
 
-Clock* imx8mq_clko1_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_800m, &imx_clk_27m,     &imx_sys1_pll_200m,
-    &imx_audio_pll2_out, &imx_sys2_pll_500m, &imx_vpu_pll_out, &imx_sys1_pll_80m,
+static constexpr uint16 imx8mq_clko1_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_800M, IMX8MQ_CLK_27M, IMX8MQ_SYS1_PLL_200M,
+    IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_SYS2_PLL_500M, IMX8MQ_VPU_PLL_OUT, IMX8MQ_SYS1_PLL_80M,
 };
-Clock* imx8mq_clko2_sels[]
-    = {&imx_clk_25m,      &imx_sys2_pll_200m,  &imx_sys1_pll_400m,  &imx_sys2_pll_166m,
-       &imx_sys3_pll_out, &imx_audio_pll1_out, &imx_video_pll1_out, &imx_clk_32k};
 
-Imx_ccm_clk imx_clk_gpt1(IMX8MQ_CLK_GPT1, imx8mq_gpt1_sels, (CCM_VA + 0xb580));
-Imx_ccm_clk imx_clk_wdog(IMX8MQ_CLK_WDOG, imx8mq_wdog_sels, (CCM_VA + 0xb900));
-Imx_ccm_clk imx_clk_wrclk(IMX8MQ_CLK_WRCLK, imx8mq_wrclk_sels, (CCM_VA + 0xb980));
-Imx_ccm_clk imx_clk_clko1(IMX8MQ_CLK_CLKO1, imx8mq_clko1_sels, (CCM_VA + 0xba00));
-Imx_ccm_clk imx_clk_clko2(IMX8MQ_CLK_CLKO2, imx8mq_clko2_sels, (CCM_VA + 0xba80));
+static constexpr uint16 imx8mq_clko2_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS2_PLL_166M,
+    IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_CLK_32K,
+};
 
-Clock* imx8mq_dsi_core_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_266m, &imx_sys2_pll_250m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_dsi_core_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_dsi_phy_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_125m, &imx_sys2_pll_100m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_clk_ext2,      &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_dsi_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_CLK_EXT2, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_dsi_dbi_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_266m, &imx_sys2_pll_100m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_dsi_dbi_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_dsi_esc_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_100m, &imx_sys1_pll_80m, &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_clk_ext3,     &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_dsi_esc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
 };
-Clock* imx8mq_dsi_ahb_sels[]
-    = {&imx_clk_25m,        &imx_sys2_pll_100m, &imx_sys1_pll_80m, &imx_sys1_pll_800m,
-       &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_clk_ext3,     &imx_audio_pll2_out};
 
-Imx_ccm_clk imx_clk_dsi_core(IMX8MQ_CLK_DSI_CORE, imx8mq_dsi_core_sels, (CCM_VA + 0xbb00));
-Imx_ccm_clk imx_clk_dsi_phy_ref(IMX8MQ_CLK_DSI_PHY_REF, imx8mq_dsi_phy_sels, (CCM_VA + 0xbb80));
-Imx_ccm_clk imx_clk_dsi_dbi(IMX8MQ_CLK_DSI_DBI, imx8mq_dsi_dbi_sels, (CCM_VA + 0xbc00));
-Imx_ccm_clk imx_clk_dsi_esc(IMX8MQ_CLK_DSI_ESC, imx8mq_dsi_esc_sels, (CCM_VA + 0xbc80));
-Imx_ccm_clk imx_clk_dsi_ahb(IMX8MQ_CLK_DSI_AHB, imx8mq_dsi_ahb_sels, (CCM_VA + 0x9200));
-Imx_clock_div imx_clk_dsi_ipg_div(IMX8MQ_CLK_DSI_IPG_DIV, &imx_clk_dsi_ahb, (CCM_VA + 0x9280), 0, 6,
-                                  CLOCK_ENABLE_PARENT);
+static constexpr uint16 imx8mq_dsi_ahb_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Clock* imx8mq_csi1_core_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_266m, &imx_sys2_pll_250m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_csi1_core_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_csi1_phy_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_125m, &imx_sys2_pll_100m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_clk_ext2,      &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_csi1_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_CLK_EXT2, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_csi1_esc_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_100m, &imx_sys1_pll_80m, &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_clk_ext3,     &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_csi1_esc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Clock* imx8mq_csi2_core_sels[] = {
-    &imx_clk_25m,        &imx_sys1_pll_266m, &imx_sys2_pll_250m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_csi2_core_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_csi2_phy_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_125m, &imx_sys2_pll_100m,  &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_clk_ext2,      &imx_audio_pll2_out, &imx_video_pll1_out,
+static constexpr uint16 imx8mq_csi2_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_CLK_EXT2, IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_VIDEO_PLL1_OUT,
 };
 
-Clock* imx8mq_csi2_esc_sels[] = {
-    &imx_clk_25m,        &imx_sys2_pll_100m, &imx_sys1_pll_80m, &imx_sys1_pll_800m,
-    &imx_sys2_pll_1000m, &imx_sys3_pll_out,  &imx_clk_ext3,     &imx_audio_pll2_out,
+static constexpr uint16 imx8mq_csi2_esc_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_800M,
+    IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_CLK_EXT3, IMX8MQ_AUDIO_PLL2_OUT,
 };
 
-Imx_ccm_clk imx_clk_csi1_core(IMX8MQ_CLK_CSI1_CORE, imx8mq_csi1_core_sels, (CCM_VA + 0xbd00));
-Imx_ccm_clk imx_clk_csi1_phy_ref(IMX8MQ_CLK_CSI1_PHY_REF, imx8mq_csi1_phy_sels, (CCM_VA + 0xbd80));
-Imx_ccm_clk imx_clk_csi1_esc(IMX8MQ_CLK_CSI1_ESC, imx8mq_csi1_esc_sels, (CCM_VA + 0xbe00));
-Imx_ccm_clk imx_clk_csi2_core(IMX8MQ_CLK_CSI2_CORE, imx8mq_csi2_core_sels, (CCM_VA + 0xbe80));
-Imx_ccm_clk imx_clk_csi2_phy_ref(IMX8MQ_CLK_CSI2_PHY_REF, imx8mq_csi2_phy_sels, (CCM_VA + 0xbf00));
-Imx_ccm_clk imx_clk_csi2_esc(IMX8MQ_CLK_CSI2_ESC, imx8mq_csi2_esc_sels, (CCM_VA + 0xbf80));
+static constexpr uint16 imx8mq_pcie2_ctrl_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_266M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS2_PLL_333M, IMX8MQ_SYS3_PLL_OUT,
+};
 
-Clock* imx8mq_pcie2_ctrl_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_250m, &imx_sys2_pll_200m, &imx_sys1_pll_266m,
-    &imx_sys1_pll_800m, &imx_sys2_pll_500m, &imx_sys2_pll_333m, &imx_sys3_pll_out,
+static constexpr uint16 imx8mq_pcie2_phy_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS2_PLL_500M, IMX8MQ_CLK_EXT1, IMX8MQ_CLK_EXT2,
+    IMX8MQ_CLK_EXT3, IMX8MQ_CLK_EXT4, IMX8MQ_SYS1_PLL_400M,
 };
 
-Clock* imx8mq_pcie2_phy_sels[] = {
-    &imx_clk_25m,  &imx_sys2_pll_100m, &imx_sys2_pll_500m, &imx_clk_ext1,
-    &imx_clk_ext2, &imx_clk_ext3,      &imx_clk_ext4,      &imx_sys1_pll_400m,
+static constexpr uint16 imx8mq_pcie2_aux_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS3_PLL_OUT,
+    IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_200M,
 };
 
-Clock* imx8mq_pcie2_aux_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys2_pll_50m,  &imx_sys3_pll_out,
-    &imx_sys2_pll_100m, &imx_sys1_pll_80m,  &imx_sys1_pll_160m, &imx_sys1_pll_200m,
-};
-
-Imx_ccm_clk imx_clk_pcie2_ctrl(IMX8MQ_CLK_PCIE2_CTRL, imx8mq_pcie2_ctrl_sels, (CCM_VA + 0xc000));
-Imx_ccm_clk imx_clk_pcie2_phy(IMX8MQ_CLK_PCIE2_PHY, imx8mq_pcie2_phy_sels, (CCM_VA + 0xc080));
-Imx_ccm_clk imx_clk_pcie2_aux(IMX8MQ_CLK_PCIE2_AUX, imx8mq_pcie2_aux_sels, (CCM_VA + 0xc100));
-
-Clock* imx8mq_ecspi3_sels[] = {
-    &imx_clk_25m,       &imx_sys2_pll_200m, &imx_sys1_pll_40m,  &imx_sys1_pll_160m,
-    &imx_sys1_pll_800m, &imx_sys3_pll_out,  &imx_sys2_pll_250m, &imx_audio_pll2_out,
-};
-
-Imx_ccm_clk imx_clk_ecspi3(IMX8MQ_CLK_ECSPI3, imx8mq_ecspi3_sels, (CCM_VA + 0xc180));
-
-Imx_clock_gate imx_clk_ecspi1_root(IMX8MQ_CLK_ECSPI1_ROOT, &imx_clk_ecspi1, (CCM_VA + 0x4070), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_ecspi2_root(IMX8MQ_CLK_ECSPI2_ROOT, &imx_clk_ecspi2, (CCM_VA + 0x4080), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_ecspi3_root(IMX8MQ_CLK_ECSPI3_ROOT, &imx_clk_ecspi3, (CCM_VA + 0x4090), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_enet1_root(IMX8MQ_CLK_ENET1_ROOT, &imx_clk_enet_axi, (CCM_VA + 0x40a0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_gpio1_root(IMX8MQ_CLK_GPIO1_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x40b0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpio2_root(IMX8MQ_CLK_GPIO2_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x40c0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpio3_root(IMX8MQ_CLK_GPIO3_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x40d0), 0,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpio4_root(IMX8MQ_CLK_GPIO4_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x40e0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpio5_root(IMX8MQ_CLK_GPIO5_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x40f0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_gpt1_root(IMX8MQ_CLK_GPT1_ROOT, &imx_clk_gpt1, (CCM_VA + 0x4100), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_i2c1_root(IMX8MQ_CLK_I2C1_ROOT, &imx_clk_i2c1, (CCM_VA + 0x4170), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_i2c2_root(IMX8MQ_CLK_I2C2_ROOT, &imx_clk_i2c2, (CCM_VA + 0x4180), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_i2c3_root(IMX8MQ_CLK_I2C3_ROOT, &imx_clk_i2c3, (CCM_VA + 0x4190), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_i2c4_root(IMX8MQ_CLK_I2C4_ROOT, &imx_clk_i2c4, (CCM_VA + 0x41a0), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_mu_root(IMX8MQ_CLK_MU_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x4210), 0, 3,
-                               CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_ocotp_root(IMX8MQ_CLK_OCOTP_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x4220), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_pcie1_root(IMX8MQ_CLK_PCIE1_ROOT, &imx_clk_pcie1_ctrl, (CCM_VA + 0x4250), 0,
-                                  3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_pcie2_root(IMX8MQ_CLK_PCIE2_ROOT, &imx_clk_pcie2_ctrl, (CCM_VA + 0x4640), 0,
-                                  3, CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_pwm1_root(IMX8MQ_CLK_PWM1_ROOT, &imx_clk_pwm1, (CCM_VA + 0x4280), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_pwm2_root(IMX8MQ_CLK_PWM2_ROOT, &imx_clk_pwm2, (CCM_VA + 0x4290), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_pwm3_root(IMX8MQ_CLK_PWM3_ROOT, &imx_clk_pwm3, (CCM_VA + 0x42a0), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_pwm4_root(IMX8MQ_CLK_PWM4_ROOT, &imx_clk_pwm4, (CCM_VA + 0x42b0), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_qspi_root(IMX8MQ_CLK_QSPI_ROOT, &imx_clk_qspi, (CCM_VA + 0x42f0), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_rawnand_root(IMX8MQ_CLK_RAWNAND_ROOT, &imx_clk_nand, (CCM_VA + 0x4300), 0, 3,
-                                    CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_nand_usdhc_bus_rawnand_clk(IMX8MQ_CLK_NAND_USDHC_BUS_RAWNAND_CLK,
-                                                  &imx_clk_nand_usdhc_bus, (CCM_VA + 0x4300), 0, 3,
-                                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_sai1_root(IMX8MQ_CLK_SAI1_ROOT, &imx_clk_sai1, (CCM_VA + 0x4330), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai1_ipg(IMX8MQ_CLK_SAI1_IPG, &imx_clk_ipg_audio_root, (CCM_VA + 0x4330), 0,
-                                3, CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_sai2_root(IMX8MQ_CLK_SAI2_ROOT, &imx_clk_sai2, (CCM_VA + 0x4340), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_sai2_ipg(IMX8MQ_CLK_SAI2_IPG, &imx_clk_ipg_root, (CCM_VA + 0x4340), 0, 3,
-                                CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai3_root(IMX8MQ_CLK_SAI3_ROOT, &imx_clk_sai3, (CCM_VA + 0x4350), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai3_ipg(IMX8MQ_CLK_SAI3_IPG, &imx_clk_ipg_root, (CCM_VA + 0x4350), 0, 3,
-                                CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai4_root(IMX8MQ_CLK_SAI4_ROOT, &imx_clk_sai4, (CCM_VA + 0x4360), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai4_ipg(IMX8MQ_CLK_SAI4_IPG, &imx_clk_ipg_audio_root, (CCM_VA + 0x4360), 0,
-                                3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai5_root(IMX8MQ_CLK_SAI5_ROOT, &imx_clk_sai5, (CCM_VA + 0x4370), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai5_ipg(IMX8MQ_CLK_SAI5_IPG, &imx_clk_ipg_audio_root, (CCM_VA + 0x4370), 0,
-                                3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai6_root(IMX8MQ_CLK_SAI6_ROOT, &imx_clk_sai6, (CCM_VA + 0x4380), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sai6_ipg(IMX8MQ_CLK_SAI6_IPG, &imx_clk_ipg_audio_root, (CCM_VA + 0x4380), 0,
-                                3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_snvs_root(IMX8MQ_CLK_SNVS_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x4470), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_uart1_root(IMX8MQ_CLK_UART1_ROOT, &imx_clk_uart1, (CCM_VA + 0x4490), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_uart2_root(IMX8MQ_CLK_UART2_ROOT, &imx_clk_uart2, (CCM_VA + 0x44a0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_uart3_root(IMX8MQ_CLK_UART3_ROOT, &imx_clk_uart3, (CCM_VA + 0x44b0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_uart4_root(IMX8MQ_CLK_UART4_ROOT, &imx_clk_uart4, (CCM_VA + 0x44c0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_usb1_ctrl_root(IMX8MQ_CLK_USB1_CTRL_ROOT, &imx_clk_usb_bus,
-                                      (CCM_VA + 0x44d0), 0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_usb2_ctrl_root(IMX8MQ_CLK_USB2_CTRL_ROOT, &imx_clk_usb_bus,
-                                      (CCM_VA + 0x44e0), 0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_usb1_phy_root(IMX8MQ_CLK_USB1_PHY_ROOT, &imx_clk_usb_phy_ref,
-                                     (CCM_VA + 0x44f0), 0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_usb2_phy_root(IMX8MQ_CLK_USB2_PHY_ROOT, &imx_clk_usb_phy_ref,
-                                     (CCM_VA + 0x4500), 0, 3, CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_usdhc1_root(IMX8MQ_CLK_USDHC1_ROOT, &imx_clk_usdhc1, (CCM_VA + 0x4510), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_usdhc2_root(IMX8MQ_CLK_USDHC2_ROOT, &imx_clk_usdhc2, (CCM_VA + 0x4520), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_wdog1_root(IMX8MQ_CLK_WDOG1_ROOT, &imx_clk_wdog, (CCM_VA + 0x4530), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_wdog2_root(IMX8MQ_CLK_WDOG2_ROOT, &imx_clk_wdog, (CCM_VA + 0x4540), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_wdog3_root(IMX8MQ_CLK_WDOG3_ROOT, &imx_clk_wdog, (CCM_VA + 0x4550), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_vpu_g1_root(IMX8MQ_CLK_VPU_G1_ROOT, &imx_clk_vpu_g1, (CCM_VA + 0x4560), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_gpu_root(IMX8MQ_CLK_GPU_ROOT, &imx_clk_gpu_core_div, (CCM_VA + 0x4570), 0, 3,
-                                CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_vpu_g2_root(IMX8MQ_CLK_VPU_G2_ROOT, &imx_clk_vpu_g2, (CCM_VA + 0x45a0), 0, 3,
-                                   CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_disp_root(IMX8MQ_CLK_DISP_ROOT, &imx_clk_disp_dc8000, (CCM_VA + 0x45d0), 0,
-                                 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_disp_axi_root(IMX8MQ_CLK_DISP_AXI_ROOT, &imx_clk_disp_axi, (CCM_VA + 0x45d0),
-                                     0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_disp_apb_root(IMX8MQ_CLK_DISP_APB_ROOT, &imx_clk_disp_apb, (CCM_VA + 0x45d0),
-                                     0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_disp_rtrm_root(IMX8MQ_CLK_DISP_RTRM_ROOT, &imx_clk_disp_rtrm,
-                                      (CCM_VA + 0x45d0), 0, 3, CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_tmu_root(IMX8MQ_CLK_TMU_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x4620), 0, 3,
-                                CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_vpu_dec_root(IMX8MQ_CLK_VPU_DEC_ROOT, &imx_clk_vpu_bus, (CCM_VA + 0x4630), 0,
-                                    3, CLOCK_ENABLE_PARENT);
-
-Imx_clock_gate imx_clk_csi1_root(IMX8MQ_CLK_CSI1_ROOT, &imx_clk_csi1_core, (CCM_VA + 0x4650), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_csi2_root(IMX8MQ_CLK_CSI2_ROOT, &imx_clk_csi2_core, (CCM_VA + 0x4660), 0, 3,
-                                 CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sdma1_root(IMX8MQ_CLK_SDMA1_ROOT, &imx_clk_ipg_root, (CCM_VA + 0x43a0), 0, 3,
-                                  CLOCK_ENABLE_PARENT);
-Imx_clock_gate imx_clk_sdma2_root(IMX8MQ_CLK_SDMA2_ROOT, &imx_clk_ipg_audio_root, (CCM_VA + 0x43b0),
-                                  0, 3, CLOCK_ENABLE_PARENT);
-
-Imx_fixdiv_clock imx_gpt_3m_clk(IMX8MQ_GPT_3M_CLK, &imx_clk_25m, 1, 8);
+static constexpr uint16 imx8mq_ecspi3_sels[] = {
+    IMX8MQ_CLK_25M, IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS1_PLL_160M,
+    IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS2_PLL_250M, IMX8MQ_AUDIO_PLL2_OUT,
+};
 
-Errno
-Imx_ClkCtrl::probe(void) {
-
-    /* Analog Clocks and PLLs*/
-    _clks[IMX8MQ_CLK_DUMMY] = &imx_clk_dummy;
-    _clks[IMX8MQ_CLK_32K] = &imx_clk_32k;
-    _clks[IMX8MQ_CLK_25M] = &imx_clk_25m;
-    _clks[IMX8MQ_CLK_27M] = &imx_clk_27m;
-    _clks[IMX8MQ_CLK_EXT1] = &imx_clk_ext1;
-    _clks[IMX8MQ_CLK_EXT2] = &imx_clk_ext2;
-    _clks[IMX8MQ_CLK_EXT3] = &imx_clk_ext3;
-    _clks[IMX8MQ_CLK_EXT4] = &imx_clk_ext4;
-    _clks[IMX8MQ_ARM_PLL_REF_SEL] = &imx_arm_pll_ref_sel;
-    _clks[IMX8MQ_GPU_PLL_REF_SEL] = &imx_gpu_pll_ref_sel;
-    _clks[IMX8MQ_VPU_PLL_REF_SEL] = &imx_vpu_pll_ref_sel;
-    _clks[IMX8MQ_AUDIO_PLL1_REF_SEL] = &imx_audio_pll1_ref_sel;
-    _clks[IMX8MQ_AUDIO_PLL2_REF_SEL] = &imx_audio_pll2_ref_sel;
-    _clks[IMX8MQ_VIDEO_PLL1_REF_SEL] = &imx_video_pll1_ref_sel;
-    _clks[IMX8MQ_SYS3_PLL1_REF_SEL] = &imx_sys3_pll1_ref_sel;
-    _clks[IMX8MQ_DRAM_PLL1_REF_SEL] = &imx_dram_pll1_ref_sel;
-    _clks[IMX8MQ_VIDEO2_PLL1_REF_SEL] = &imx_video2_pll1_ref_sel;
-    _clks[IMX8MQ_ARM_PLL_REF_DIV] = &imx_arm_pll_ref_div;
-    _clks[IMX8MQ_GPU_PLL_REF_DIV] = &imx_gpu_pll_ref_div;
-    _clks[IMX8MQ_VPU_PLL_REF_DIV] = &imx_vpu_pll_ref_div;
-    _clks[IMX8MQ_AUDIO_PLL1_REF_DIV] = &imx_audio_pll1_ref_div;
-    _clks[IMX8MQ_AUDIO_PLL2_REF_DIV] = &imx_audio_pll2_ref_div;
-    _clks[IMX8MQ_VIDEO_PLL1_REF_DIV] = &imx_video_pll1_ref_div;
-    _clks[IMX8MQ_ARM_PLL] = &imx_arm_pll;
-    _clks[IMX8MQ_GPU_PLL] = &imx_gpu_pll;
-    _clks[IMX8MQ_VPU_PLL] = &imx_vpu_pll;
-    _clks[IMX8MQ_AUDIO_PLL1] = &imx_audio_pll1;
-    _clks[IMX8MQ_AUDIO_PLL2] = &imx_audio_pll2;
-    _clks[IMX8MQ_VIDEO_PLL1] = &imx_video_pll1;
-    _clks[IMX8MQ_ARM_PLL_BYPASS] = &imx_arm_pll_bypass;
-    _clks[IMX8MQ_GPU_PLL_BYPASS] = &imx_gpu_pll_bypass;
-    _clks[IMX8MQ_VPU_PLL_BYPASS] = &imx_vpu_pll_bypass;
-    _clks[IMX8MQ_AUDIO_PLL1_BYPASS] = &imx_audio_pll1_bypass;
-    _clks[IMX8MQ_AUDIO_PLL2_BYPASS] = &imx_audio_pll2_bypass;
-    _clks[IMX8MQ_VIDEO_PLL1_BYPASS] = &imx_video_pll1_bypass;
+/**
+ * The clock tree. Parents come before their children, IMX8MQ_CLK_ARM has no entry as
+ * changes to the core clock are ignored.
+ */
+static constexpr Clk_def clk_defs[] = {
+    /* Analog Clocks and PLLs */
+    def_fixed(IMX8MQ_CLK_DUMMY, 0),
+    def_fixed(IMX8MQ_CLK_32K, 32768),
+    def_fixed(IMX8MQ_CLK_25M, 25000000),
+    def_fixed(IMX8MQ_CLK_27M, 27000000),
+    def_fixed(IMX8MQ_CLK_EXT1, 133000000),
+    def_fixed(IMX8MQ_CLK_EXT2, 133000000),
+    def_fixed(IMX8MQ_CLK_EXT3, 133000000),
+    def_fixed(IMX8MQ_CLK_EXT4, 133000000),
+
+    def_mux(IMX8MQ_ARM_PLL_REF_SEL, (ANATOP_VA + 0x28), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_GPU_PLL_REF_SEL, (ANATOP_VA + 0x18), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_VPU_PLL_REF_SEL, (ANATOP_VA + 0x20), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_AUDIO_PLL1_REF_SEL, (ANATOP_VA + 0x0), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_AUDIO_PLL2_REF_SEL, (ANATOP_VA + 0x8), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_VIDEO_PLL1_REF_SEL, (ANATOP_VA + 0x10), 16, 2, pll_ref_sels),
+    def_mux(IMX8MQ_SYS3_PLL1_REF_SEL, (ANATOP_VA + 0x48), 0, 2, pll_ref_sels),
+    def_mux(IMX8MQ_DRAM_PLL1_REF_SEL, (ANATOP_VA + 0x60), 0, 2, pll_ref_sels),
+    def_mux(IMX8MQ_VIDEO2_PLL1_REF_SEL, (ANATOP_VA + 0x54), 0, 2, pll_ref_sels),
+
+    def_div(IMX8MQ_ARM_PLL_REF_DIV, IMX8MQ_ARM_PLL_REF_SEL, (ANATOP_VA + 0x28), 5, 6),
+    def_div(IMX8MQ_GPU_PLL_REF_DIV, IMX8MQ_GPU_PLL_REF_SEL, (ANATOP_VA + 0x18), 5, 6),
+    def_div(IMX8MQ_VPU_PLL_REF_DIV, IMX8MQ_VPU_PLL_REF_SEL, (ANATOP_VA + 0x20), 5, 6),
+    def_div(IMX8MQ_AUDIO_PLL1_REF_DIV, IMX8MQ_AUDIO_PLL1_REF_SEL, (ANATOP_VA + 0x0), 5, 6),
+    def_div(IMX8MQ_AUDIO_PLL2_REF_DIV, IMX8MQ_AUDIO_PLL2_REF_SEL, (ANATOP_VA + 0x8), 5, 6),
+    def_div(IMX8MQ_VIDEO_PLL1_REF_DIV, IMX8MQ_VIDEO_PLL1_REF_SEL, (ANATOP_VA + 0x10), 5, 6),
+
+    def_frac_pll(IMX8MQ_ARM_PLL, IMX8MQ_ARM_PLL_REF_DIV, (ANATOP_VA + 0x28)),
+    def_frac_pll(IMX8MQ_GPU_PLL, IMX8MQ_GPU_PLL_REF_DIV, (ANATOP_VA + 0x18)),
+    def_frac_pll(IMX8MQ_VPU_PLL, IMX8MQ_VPU_PLL_REF_DIV, (ANATOP_VA + 0x20)),
+    def_frac_pll(IMX8MQ_AUDIO_PLL1, IMX8MQ_AUDIO_PLL1_REF_DIV, (ANATOP_VA + 0x0)),
+    def_frac_pll(IMX8MQ_AUDIO_PLL2, IMX8MQ_AUDIO_PLL2_REF_DIV, (ANATOP_VA + 0x8)),
+    def_frac_pll(IMX8MQ_VIDEO_PLL1, IMX8MQ_VIDEO_PLL1_REF_DIV, (ANATOP_VA + 0x10)),
+
+    /* PLL bypass out */
+    def_mux(IMX8MQ_ARM_PLL_BYPASS, (ANATOP_VA + 0x28), 14, 1, arm_pll_bypass_sels,
+            (CLOCK_CHANGE_RATE_PARENT)),
+    def_mux(IMX8MQ_GPU_PLL_BYPASS, (ANATOP_VA + 0x18), 14, 1, gpu_pll_bypass_sels),
+    def_mux(IMX8MQ_VPU_PLL_BYPASS, (ANATOP_VA + 0x20), 14, 1, vpu_pll_bypass_sels),
+    def_mux(IMX8MQ_AUDIO_PLL1_BYPASS, (ANATOP_VA + 0x0), 14, 1, audio_pll1_bypass_sels),
+    def_mux(IMX8MQ_AUDIO_PLL2_BYPASS, (ANATOP_VA + 0x8), 14, 1, audio_pll2_bypass_sels),
+    def_mux(IMX8MQ_VIDEO_PLL1_BYPASS, (ANATOP_VA + 0x10), 14, 1, video_pll1_bypass_sels),
 
     /* PLL OUT GATE */
-    _clks[IMX8MQ_ARM_PLL_OUT] = &imx_arm_pll_out;
-    _clks[IMX8MQ_GPU_PLL_OUT] = &imx_gpu_pll_out;
-    _clks[IMX8MQ_VPU_PLL_OUT] = &imx_vpu_pll_out;
-    _clks[IMX8MQ_AUDIO_PLL1_OUT] = &imx_audio_pll1_out;
-    _clks[IMX8MQ_AUDIO_PLL2_OUT] = &imx_audio_pll2_out;
-    _clks[IMX8MQ_VIDEO_PLL1_OUT] = &imx_video_pll1_out;
-    _clks[IMX8MQ_SYS1_PLL_OUT] = &imx_sys1_pll_out;
-    _clks[IMX8MQ_SYS2_PLL_OUT] = &imx_sys2_pll_out;
-    _clks[IMX8MQ_SYS3_PLL_OUT] = &imx_sys3_pll_out;
-    _clks[IMX8MQ_DRAM_PLL_OUT] = &imx_dram_pll_out;
-    _clks[IMX8MQ_VIDEO2_PLL_OUT] = &imx_video2_pll_out;
+    def_gate(IMX8MQ_ARM_PLL_OUT, IMX8MQ_ARM_PLL_BYPASS, (ANATOP_VA + 0x28), 21, 1),
+    def_gate(IMX8MQ_GPU_PLL_OUT, IMX8MQ_GPU_PLL_BYPASS, (ANATOP_VA + 0x18), 21, 1),
+    def_gate(IMX8MQ_VPU_PLL_OUT, IMX8MQ_VPU_PLL_BYPASS, (ANATOP_VA + 0x20), 21, 1),
+    def_gate(IMX8MQ_AUDIO_PLL1_OUT, IMX8MQ_AUDIO_PLL1_BYPASS, (ANATOP_VA + 0x0), 21, 1),
+    def_gate(IMX8MQ_AUDIO_PLL2_OUT, IMX8MQ_AUDIO_PLL2_BYPASS, (ANATOP_VA + 0x8), 21, 1),
+    def_gate(IMX8MQ_VIDEO_PLL1_OUT, IMX8MQ_VIDEO_PLL1_BYPASS, (ANATOP_VA + 0x10), 21, 1),
+
+    def_fixed(IMX8MQ_SYS1_PLL_OUT, 800000000),
+    def_fixed(IMX8MQ_SYS2_PLL_OUT, 1000000000),
+
+    def_sccg_pll(IMX8MQ_SYS3_PLL_OUT, IMX8MQ_SYS3_PLL1_REF_SEL, (ANATOP_VA + 0x48), true),
+    def_sccg_pll(IMX8MQ_DRAM_PLL_OUT, IMX8MQ_DRAM_PLL1_REF_SEL, (ANATOP_VA + 0x60), true),
+    def_sccg_pll(IMX8MQ_VIDEO2_PLL_OUT, IMX8MQ_VIDEO2_PLL1_REF_SEL, (ANATOP_VA + 0x54), false),
 
     /* SYS PLL1 fixed output */
-    _clks[IMX8MQ_SYS1_PLL_40M_CG] = &imx_sys1_pll_40m_cg;
-    _clks[IMX8MQ_SYS1_PLL_80M_CG] = &imx_sys1_pll_80m_cg;
-    _clks[IMX8MQ_SYS1_PLL_100M_CG] = &imx_sys1_pll_100m_cg;
-    _clks[IMX8MQ_SYS1_PLL_133M_CG] = &imx_sys1_pll_133m_cg;
-    _clks[IMX8MQ_SYS1_PLL_160M_CG] = &imx_sys1_pll_160m_cg;
-    _clks[IMX8MQ_SYS1_PLL_200M_CG] = &imx_sys1_pll_200m_cg;
-    _clks[IMX8MQ_SYS1_PLL_266M_CG] = &imx_sys1_pll_266m_cg;
-    _clks[IMX8MQ_SYS1_PLL_400M_CG] = &imx_sys1_pll_400m_cg;
-    _clks[IMX8MQ_SYS1_PLL_800M_CG] = &imx_sys1_pll_800m_cg;
-    _clks[IMX8MQ_SYS1_PLL_40M] = &imx_sys1_pll_40m;
-    _clks[IMX8MQ_SYS1_PLL_80M] = &imx_sys1_pll_80m;
-    _clks[IMX8MQ_SYS1_PLL_100M] = &imx_sys1_pll_100m;
-    _clks[IMX8MQ_SYS1_PLL_133M] = &imx_sys1_pll_133m;
-    _clks[IMX8MQ_SYS1_PLL_160M] = &imx_sys1_pll_160m;
-    _clks[IMX8MQ_SYS1_PLL_200M] = &imx_sys1_pll_200m;
-    _clks[IMX8MQ_SYS1_PLL_266M] = &imx_sys1_pll_266m;
-    _clks[IMX8MQ_SYS1_PLL_400M] = &imx_sys1_pll_400m;
-    _clks[IMX8MQ_SYS1_PLL_800M] = &imx_sys1_pll_800m;
+    def_gate(IMX8MQ_SYS1_PLL_40M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 9, 1),
+    def_gate(IMX8MQ_SYS1_PLL_80M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 11, 1),
+    def_gate(IMX8MQ_SYS1_PLL_100M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 13, 1),
+    def_gate(IMX8MQ_SYS1_PLL_133M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 15, 1),
+    def_gate(IMX8MQ_SYS1_PLL_160M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 17, 1),
+    def_gate(IMX8MQ_SYS1_PLL_200M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 19, 1),
+    def_gate(IMX8MQ_SYS1_PLL_266M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 21, 1),
+    def_gate(IMX8MQ_SYS1_PLL_400M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 23, 1),
+    def_gate(IMX8MQ_SYS1_PLL_800M_CG, IMX8MQ_SYS1_PLL_OUT, (ANATOP_VA + 0x30), 25, 1),
+
+    def_fixdiv(IMX8MQ_SYS1_PLL_40M, IMX8MQ_SYS1_PLL_40M_CG, 20),
+    def_fixdiv(IMX8MQ_SYS1_PLL_80M, IMX8MQ_SYS1_PLL_80M_CG, 10),
+    def_fixdiv(IMX8MQ_SYS1_PLL_100M, IMX8MQ_SYS1_PLL_100M_CG, 8),
+    def_fixdiv(IMX8MQ_SYS1_PLL_133M, IMX8MQ_SYS1_PLL_133M_CG, 6),
+    def_fixdiv(IMX8MQ_SYS1_PLL_160M, IMX8MQ_SYS1_PLL_160M_CG, 5),
+    def_fixdiv(IMX8MQ_SYS1_PLL_200M, IMX8MQ_SYS1_PLL_200M_CG, 4),
+    def_fixdiv(IMX8MQ_SYS1_PLL_266M, IMX8MQ_SYS1_PLL_266M_CG, 3),
+    def_fixdiv(IMX8MQ_SYS1_PLL_400M, IMX8MQ_SYS1_PLL_400M_CG, 2),
+    def_fixdiv(IMX8MQ_SYS1_PLL_800M, IMX8MQ_SYS1_PLL_800M_CG, 1),
 
     /* SYS PLL2 fixed output */
-    _clks[IMX8MQ_SYS2_PLL_50M_CG] = &imx_sys2_pll_50m_cg;
-    _clks[IMX8MQ_SYS2_PLL_100M_CG] = &imx_sys2_pll_100m_cg;
-    _clks[IMX8MQ_SYS2_PLL_125M_CG] = &imx_sys2_pll_125m_cg;
-    _clks[IMX8MQ_SYS2_PLL_166M_CG] = &imx_sys2_pll_166m_cg;
-    _clks[IMX8MQ_SYS2_PLL_200M_CG] = &imx_sys2_pll_200m_cg;
-    _clks[IMX8MQ_SYS2_PLL_250M_CG] = &imx_sys2_pll_250m_cg;
-    _clks[IMX8MQ_SYS2_PLL_333M_CG] = &imx_sys2_pll_333m_cg;
-    _clks[IMX8MQ_SYS2_PLL_500M_CG] = &imx_sys2_pll_500m_cg;
-    _clks[IMX8MQ_SYS2_PLL_1000M_CG] = &imx_sys2_pll_1000m_cg;
-    _clks[IMX8MQ_SYS2_PLL_50M] = &imx_sys2_pll_50m;
-    _clks[IMX8MQ_SYS2_PLL_100M] = &imx_sys2_pll_100m;
-    _clks[IMX8MQ_SYS2_PLL_125M] = &imx_sys2_pll_125m;
-    _clks[IMX8MQ_SYS2_PLL_166M] = &imx_sys2_pll_166m;
-    _clks[IMX8MQ_SYS2_PLL_200M] = &imx_sys2_pll_200m;
-    _clks[IMX8MQ_SYS2_PLL_250M] = &imx_sys2_pll_250m;
-    _clks[IMX8MQ_SYS2_PLL_333M] = &imx_sys2_pll_333m;
-    _clks[IMX8MQ_SYS2_PLL_500M] = &imx_sys2_pll_500m;
-    _clks[IMX8MQ_SYS2_PLL_1000M] = &imx_sys2_pll_1000m;
-
-    _clks[IMX8MQ_CLK_A53_SRC] = &imx_clk_a53_src;
-    _clks[IMX8MQ_CLK_M4_SRC] = &imx_clk_m4_src;
-    _clks[IMX8MQ_CLK_VPU_SRC] = &imx_clk_vpu_src;
-    _clks[IMX8MQ_CLK_GPU_CORE_SRC] = &imx_clk_gpu_core_src;
-    _clks[IMX8MQ_CLK_GPU_SHADER_SRC] = &imx_clk_gpu_shader_src;
-    _clks[IMX8MQ_CLK_A53_CG] = &imx_clk_a53_cg;
-    _clks[IMX8MQ_CLK_M4_CG] = &imx_clk_m4_cg;
-    _clks[IMX8MQ_CLK_VPU_CG] = &imx_clk_vpu_cg;
-    _clks[IMX8MQ_CLK_GPU_CORE_CG] = &imx_clk_gpu_core_cg;
-    _clks[IMX8MQ_CLK_GPU_SHADER_CG] = &imx_clk_gpu_shader_cg;
-    _clks[IMX8MQ_CLK_A53_DIV] = &imx_clk_a53_div;
-    _clks[IMX8MQ_CLK_M4_DIV] = &imx_clk_m4_div;
-    _clks[IMX8MQ_CLK_VPU_DIV] = &imx_clk_vpu_div;
-    _clks[IMX8MQ_CLK_GPU_CORE_DIV] = &imx_clk_gpu_core_div;
-    _clks[IMX8MQ_CLK_GPU_SHADER_DIV] = &imx_clk_gpu_shader_div;
-
-    /*bus clocks*/
-    _clks[IMX8MQ_CLK_MAIN_AXI] = &imx_clk_main_axi;
-    _clks[IMX8MQ_CLK_ENET_AXI] = &imx_clk_enet_axi;
-    _clks[IMX8MQ_CLK_NAND_USDHC_BUS] = &imx_clk_nand_usdhc_bus;
-    _clks[IMX8MQ_CLK_VPU_BUS] = &imx_clk_vpu_bus;
-    _clks[IMX8MQ_CLK_DISP_AXI] = &imx_clk_disp_axi;
-    _clks[IMX8MQ_CLK_DISP_APB] = &imx_clk_disp_apb;
-    _clks[IMX8MQ_CLK_DISP_RTRM] = &imx_clk_disp_rtrm;
-    _clks[IMX8MQ_CLK_USB_BUS] = &imx_clk_usb_bus;
-    _clks[IMX8MQ_CLK_GPU_AXI] = &imx_clk_gpu_axi;
-    _clks[IMX8MQ_CLK_GPU_AHB] = &imx_clk_gpu_ahb;
-    _clks[IMX8MQ_CLK_NOC] = &imx_clk_noc;
-    _clks[IMX8MQ_CLK_NOC_APB] = &imx_clk_noc_apb;
-
+    def_gate(IMX8MQ_SYS2_PLL_50M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 9, 1),
+    def_gate(IMX8MQ_SYS2_PLL_100M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 11, 1),
+    def_gate(IMX8MQ_SYS2_PLL_125M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 13, 1),
+    def_gate(IMX8MQ_SYS2_PLL_166M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 15, 1),
+    def_gate(IMX8MQ_SYS2_PLL_200M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 17, 1),
+    def_gate(IMX8MQ_SYS2_PLL_250M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 19, 1),
+    def_gate(IMX8MQ_SYS2_PLL_333M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 21, 1),
+    def_gate(IMX8MQ_SYS2_PLL_500M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 23, 1),
+    def_gate(IMX8MQ_SYS2_PLL_1000M_CG, IMX8MQ_SYS2_PLL_OUT, (ANATOP_VA + 0x3c), 25, 1),
+
+    def_fixdiv(IMX8MQ_SYS2_PLL_50M, IMX8MQ_SYS2_PLL_50M_CG, 20),
+    def_fixdiv(IMX8MQ_SYS2_PLL_100M, IMX8MQ_SYS2_PLL_100M_CG, 10),
+    def_fixdiv(IMX8MQ_SYS2_PLL_125M, IMX8MQ_SYS2_PLL_125M_CG, 8),
+    def_fixdiv(IMX8MQ_SYS2_PLL_166M, IMX8MQ_SYS2_PLL_166M_CG, 6),
+    def_fixdiv(IMX8MQ_SYS2_PLL_200M, IMX8MQ_SYS2_PLL_200M_CG, 5),
+    def_fixdiv(IMX8MQ_SYS2_PLL_250M, IMX8MQ_SYS2_PLL_250M_CG, 4),
+    def_fixdiv(IMX8MQ_SYS2_PLL_333M, IMX8MQ_SYS2_PLL_333M_CG, 3),
+    def_fixdiv(IMX8MQ_SYS2_PLL_500M, IMX8MQ_SYS2_PLL_500M_CG, 2),
+    def_fixdiv(IMX8MQ_SYS2_PLL_1000M, IMX8MQ_SYS2_PLL_1000M_CG, 1),
+
+    /* CCM Clocks */
+
+    /* CORE */
+    def_mux(IMX8MQ_CLK_A53_SRC, (CCM_VA + 0x8000), 24, 3, imx8mq_a53_sels, CLOCK_ENABLE_PARENT),
+    def_mux(IMX8MQ_CLK_M4_SRC, (CCM_VA + 0x8080), 24, 3, imx8mq_arm_m4_sels, CLOCK_ENABLE_PARENT),
+    def_mux(IMX8MQ_CLK_VPU_SRC, (CCM_VA + 0x8100), 24, 3, imx8mq_vpu_sels, CLOCK_ENABLE_PARENT),
+    def_mux(IMX8MQ_CLK_GPU_CORE_SRC, (CCM_VA + 0x8180), 24, 3, imx8mq_gpu_core_sels,
+            CLOCK_ENABLE_PARENT),
+    def_mux(IMX8MQ_CLK_GPU_SHADER_SRC, (CCM_VA + 0x8200), 24, 3, imx8mq_gpu_shader_sels,
+            CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_A53_CG, IMX8MQ_CLK_A53_SRC, (CCM_VA + 0x8000), 28, 1,
+             CLOCK_ENABLE_PARENT | CLOCK_CRITICAL),
+    def_gate(IMX8MQ_CLK_M4_CG, IMX8MQ_CLK_M4_SRC, (CCM_VA + 0x8080), 28, 1, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_VPU_CG, IMX8MQ_CLK_VPU_SRC, (CCM_VA + 0x8100), 28, 1, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPU_CORE_CG, IMX8MQ_CLK_GPU_CORE_SRC, (CCM_VA + 0x8180), 28, 1,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPU_SHADER_CG, IMX8MQ_CLK_GPU_SHADER_SRC, (CCM_VA + 0x8200), 28, 1,
+             CLOCK_ENABLE_PARENT),
+
+    def_div(IMX8MQ_CLK_A53_DIV, IMX8MQ_CLK_A53_CG, (CCM_VA + 0x8000), 0, 3, CLOCK_ENABLE_PARENT),
+    def_div(IMX8MQ_CLK_M4_DIV, IMX8MQ_CLK_M4_CG, (CCM_VA + 0x8080), 0, 3, CLOCK_ENABLE_PARENT),
+    def_div(IMX8MQ_CLK_VPU_DIV, IMX8MQ_CLK_VPU_CG, (CCM_VA + 0x8100), 0, 3, CLOCK_ENABLE_PARENT),
+    def_div(IMX8MQ_CLK_GPU_CORE_DIV, IMX8MQ_CLK_GPU_CORE_CG, (CCM_VA + 0x8180), 0, 3,
+            CLOCK_ENABLE_PARENT),
+    def_div(IMX8MQ_CLK_GPU_SHADER_DIV, IMX8MQ_CLK_GPU_SHADER_CG, (CCM_VA + 0x8200), 0, 3,
+            CLOCK_ENABLE_PARENT),
+
+    /* BUS */
+    def_ccm(IMX8MQ_CLK_MAIN_AXI, imx8mq_main_axi_sels, (CCM_VA + 0x8800), true),
+    def_ccm(IMX8MQ_CLK_ENET_AXI, imx8mq_enet_axi_sels, (CCM_VA + 0x8880)),
+    def_ccm(IMX8MQ_CLK_NAND_USDHC_BUS, imx8mq_nand_usdhc_sels, (CCM_VA + 0x8900)),
+    def_ccm(IMX8MQ_CLK_VPU_BUS, imx8mq_vpu_bus_sels, (CCM_VA + 0x8980)),
+    def_ccm(IMX8MQ_CLK_DISP_AXI, imx8mq_disp_axi_sels, (CCM_VA + 0x8a00)),
+    def_ccm(IMX8MQ_CLK_DISP_APB, imx8mq_disp_apb_sels, (CCM_VA + 0x8a80)),
+    def_ccm(IMX8MQ_CLK_DISP_RTRM, imx8mq_disp_rtrm_sels, (CCM_VA + 0x8b00)),
+    def_ccm(IMX8MQ_CLK_USB_BUS, imx8mq_usb_bus_sels, (CCM_VA + 0x8b80)),
+    def_ccm(IMX8MQ_CLK_GPU_AXI, imx8mq_gpu_axi_sels, (CCM_VA + 0x8c00)),
+    def_ccm(IMX8MQ_CLK_GPU_AHB, imx8mq_gpu_ahb_sels, (CCM_VA + 0x8c80)),
+    def_ccm(IMX8MQ_CLK_NOC, imx8mq_noc_sels, (CCM_VA + 0x8d00), true),
+    def_ccm(IMX8MQ_CLK_NOC_APB, imx8mq_noc_apb_sels, (CCM_VA + 0x8d80), true),
+
+    /* AHB */
     /* AHB clock is used by the AHB bus therefore marked as critical */
-    _clks[IMX8MQ_CLK_AHB] = &imx_clk_ahb;
-    _clks[IMX8MQ_CLK_AUDIO_AHB] = &imx_clk_audio_ahb;
-
-    _clks[IMX8MQ_CLK_IPG_ROOT] = &imx_clk_ipg_root;
-    _clks[IMX8MQ_CLK_IPG_AUDIO_ROOT] = &imx_clk_ipg_audio_root;
-    _clks[IMX8MQ_CLK_DRAM_CORE] = &imx_clk_dram_core;
-    _clks[IMX8MQ_CLK_DRAM_ALT] = &imx_clk_dram_alt;
-    _clks[IMX8MQ_CLK_DRAM_APB] = &imx_clk_dram_apb;
-    _clks[IMX8MQ_CLK_VPU_G1] = &imx_clk_vpu_g1;
-    _clks[IMX8MQ_CLK_VPU_G2] = &imx_clk_vpu_g2;
-    _clks[IMX8MQ_CLK_DISP_DTRC] = &imx_clk_disp_dtrc;
-    _clks[IMX8MQ_CLK_DISP_DC8000] = &imx_clk_disp_dc8000;
-    _clks[IMX8MQ_CLK_PCIE1_CTRL] = &imx_clk_pcie1_ctrl;
-    _clks[IMX8MQ_CLK_PCIE1_PHY] = &imx_clk_pcie1_phy;
-    _clks[IMX8MQ_CLK_PCIE1_AUX] = &imx_clk_pcie1_aux;
-    _clks[IMX8MQ_CLK_DC_PIXEL] = &imx_clk_dc_pixel;
-    _clks[IMX8MQ_CLK_LCDIF_PIXEL] = &imx_clk_lcdif_pixel;
-    _clks[IMX8MQ_CLK_SAI1] = &imx_clk_sai1;
-    _clks[IMX8MQ_CLK_SAI2] = &imx_clk_sai2;
-    _clks[IMX8MQ_CLK_SAI3] = &imx_clk_sai3;
-    _clks[IMX8MQ_CLK_SAI4] = &imx_clk_sai4;
-    _clks[IMX8MQ_CLK_SAI5] = &imx_clk_sai5;
-    _clks[IMX8MQ_CLK_SAI6] = &imx_clk_sai6;
-    _clks[IMX8MQ_CLK_SPDIF1] = &imx_clk_spdif1;
-    _clks[IMX8MQ_CLK_SPDIF2] = &imx_clk_spdif2;
-    _clks[IMX8MQ_CLK_ENET_REF] = &imx_clk_enet_ref;
-    _clks[IMX8MQ_CLK_ENET_TIMER] = &imx_clk_enet_timer;
-    _clks[IMX8MQ_CLK_ENET_PHY_REF] = &imx_clk_enet_phy_ref;
-    _clks[IMX8MQ_CLK_NAND] = &imx_clk_nand;
-    _clks[IMX8MQ_CLK_QSPI] = &imx_clk_qspi;
-    _clks[IMX8MQ_CLK_USDHC1] = &imx_clk_usdhc1;
-    _clks[IMX8MQ_CLK_USDHC2] = &imx_clk_usdhc2;
-    _clks[IMX8MQ_CLK_I2C1] = &imx_clk_i2c1;
-    _clks[IMX8MQ_CLK_I2C2] = &imx_clk_i2c2;
-    _clks[IMX8MQ_CLK_I2C3] = &imx_clk_i2c3;
-    _clks[IMX8MQ_CLK_I2C4] = &imx_clk_i2c4;
-    _clks[IMX8MQ_CLK_UART1] = &imx_clk_uart1;
-    _clks[IMX8MQ_CLK_UART2] = &imx_clk_uart2;
-    _clks[IMX8MQ_CLK_UART3] = &imx_clk_uart3;
-    _clks[IMX8MQ_CLK_UART4] = &imx_clk_uart4;
-    _clks[IMX8MQ_CLK_USB_CORE_REF] = &imx_clk_usb_core_ref;
-    _clks[IMX8MQ_CLK_USB_PHY_REF] = &imx_clk_usb_phy_ref;
-    _clks[IMX8MQ_CLK_GIC] = &imx_clk_gic;
-    _clks[IMX8MQ_CLK_ECSPI1] = &imx_clk_ecspi1;
-    _clks[IMX8MQ_CLK_ECSPI2] = &imx_clk_ecspi2;
-    _clks[IMX8MQ_CLK_PWM1] = &imx_clk_pwm1;
-    _clks[IMX8MQ_CLK_PWM2] = &imx_clk_pwm2;
-    _clks[IMX8MQ_CLK_PWM3] = &imx_clk_pwm3;
-    _clks[IMX8MQ_CLK_PWM4] = &imx_clk_pwm4;
-    _clks[IMX8MQ_CLK_GPT1] = &imx_clk_gpt1;
-    _clks[IMX8MQ_CLK_WDOG] = &imx_clk_wdog;
-    _clks[IMX8MQ_CLK_WRCLK] = &imx_clk_wrclk;
-    _clks[IMX8MQ_CLK_CLKO1] = &imx_clk_clko2;
-    _clks[IMX8MQ_CLK_CLKO2] = &imx_clk_clko1;
-    _clks[IMX8MQ_CLK_DSI_CORE] = &imx_clk_dsi_core;
-    _clks[IMX8MQ_CLK_DSI_PHY_REF] = &imx_clk_dsi_phy_ref;
-    _clks[IMX8MQ_CLK_DSI_DBI] = &imx_clk_dsi_dbi;
-    _clks[IMX8MQ_CLK_DSI_ESC] = &imx_clk_dsi_esc;
-    _clks[IMX8MQ_CLK_DSI_AHB] = &imx_clk_dsi_ahb;
-    _clks[IMX8MQ_CLK_DSI_IPG_DIV] = &imx_clk_dsi_ipg_div;
-    _clks[IMX8MQ_CLK_CSI1_CORE] = &imx_clk_csi1_core;
-    _clks[IMX8MQ_CLK_CSI1_PHY_REF] = &imx_clk_csi1_phy_ref;
-    _clks[IMX8MQ_CLK_CSI1_ESC] = &imx_clk_csi1_esc;
-    _clks[IMX8MQ_CLK_CSI2_CORE] = &imx_clk_csi2_core;
-    _clks[IMX8MQ_CLK_CSI2_PHY_REF] = &imx_clk_csi2_phy_ref;
-    _clks[IMX8MQ_CLK_CSI2_ESC] = &imx_clk_csi2_esc;
-    _clks[IMX8MQ_CLK_PCIE2_CTRL] = &imx_clk_pcie2_ctrl;
-    _clks[IMX8MQ_CLK_PCIE2_PHY] = &imx_clk_pcie2_phy;
-    _clks[IMX8MQ_CLK_PCIE2_AUX] = &imx_clk_pcie2_aux;
-    _clks[IMX8MQ_CLK_ECSPI3] = &imx_clk_ecspi3;
-    _clks[IMX8MQ_CLK_ECSPI1_ROOT] = &imx_clk_ecspi1_root;
-    _clks[IMX8MQ_CLK_ECSPI2_ROOT] = &imx_clk_ecspi2_root;
-    _clks[IMX8MQ_CLK_ECSPI3_ROOT] = &imx_clk_ecspi3_root;
-    _clks[IMX8MQ_CLK_ENET1_ROOT] = &imx_clk_enet1_root;
-    _clks[IMX8MQ_CLK_GPIO1_ROOT] = &imx_clk_gpio1_root;
-    _clks[IMX8MQ_CLK_GPIO2_ROOT] = &imx_clk_gpio2_root;
-    _clks[IMX8MQ_CLK_GPIO3_ROOT] = &imx_clk_gpio4_root;
-    _clks[IMX8MQ_CLK_GPIO4_ROOT] = &imx_clk_gpio4_root;
-    _clks[IMX8MQ_CLK_GPIO5_ROOT] = &imx_clk_gpio5_root;
-    _clks[IMX8MQ_CLK_GPT1_ROOT] = &imx_clk_gpt1_root;
-    _clks[IMX8MQ_CLK_I2C1_ROOT] = &imx_clk_i2c1_root;
-    _clks[IMX8MQ_CLK_I2C2_ROOT] = &imx_clk_i2c2_root;
-    _clks[IMX8MQ_CLK_I2C3_ROOT] = &imx_clk_i2c3_root;
-    _clks[IMX8MQ_CLK_I2C4_ROOT] = &imx_clk_i2c4_root;
-    _clks[IMX8MQ_CLK_MU_ROOT] = &imx_clk_mu_root;
-    _clks[IMX8MQ_CLK_OCOTP_ROOT] = &imx_clk_ocotp_root;
-    _clks[IMX8MQ_CLK_PCIE1_ROOT] = &imx_clk_pcie1_root;
-    _clks[IMX8MQ_CLK_PCIE2_ROOT] = &imx_clk_pcie2_root;
-    _clks[IMX8MQ_CLK_PWM1_ROOT] = &imx_clk_pwm1_root;
-    _clks[IMX8MQ_CLK_PWM2_ROOT] = &imx_clk_pwm2_root;
-    _clks[IMX8MQ_CLK_PWM3_ROOT] = &imx_clk_pwm3_root;
-    _clks[IMX8MQ_CLK_PWM4_ROOT] = &imx_clk_pwm4_root;
-    _clks[IMX8MQ_CLK_QSPI_ROOT] = &imx_clk_qspi_root;
-    _clks[IMX8MQ_CLK_RAWNAND_ROOT] = &imx_clk_rawnand_root;
-    _clks[IMX8MQ_CLK_NAND_USDHC_BUS_RAWNAND_CLK] = &imx_clk_nand_usdhc_bus_rawnand_clk;
-    _clks[IMX8MQ_CLK_SAI1_ROOT] = &imx_clk_sai1_root;
-    _clks[IMX8MQ_CLK_SAI1_IPG] = &imx_clk_sai1_ipg;
-    _clks[IMX8MQ_CLK_SAI2_ROOT] = &imx_clk_sai2_root;
-    _clks[IMX8MQ_CLK_SAI2_IPG] = &imx_clk_sai2_ipg;
-    _clks[IMX8MQ_CLK_SAI3_ROOT] = &imx_clk_sai3_root;
-    _clks[IMX8MQ_CLK_SAI3_IPG] = &imx_clk_sai3_ipg;
-    _clks[IMX8MQ_CLK_SAI4_ROOT] = &imx_clk_sai4_root;
-    _clks[IMX8MQ_CLK_SAI4_IPG] = &imx_clk_sai4_ipg;
-    _clks[IMX8MQ_CLK_SAI5_ROOT] = &imx_clk_sai5_root;
-    _clks[IMX8MQ_CLK_SAI5_IPG] = &imx_clk_sai5_ipg;
-    _clks[IMX8MQ_CLK_SAI6_ROOT] = &imx_clk_sai6_root;
-    _clks[IMX8MQ_CLK_SAI6_IPG] = &imx_clk_sai6_ipg;
-    _clks[IMX8MQ_CLK_SNVS_ROOT] = &imx_clk_snvs_root;
-    _clks[IMX8MQ_CLK_UART1_ROOT] = &imx_clk_uart1_root;
-    _clks[IMX8MQ_CLK_UART2_ROOT] = &imx_clk_uart2_root;
-    _clks[IMX8MQ_CLK_UART3_ROOT] = &imx_clk_uart3_root;
-    _clks[IMX8MQ_CLK_UART4_ROOT] = &imx_clk_uart4_root;
-    _clks[IMX8MQ_CLK_USB1_CTRL_ROOT] = &imx_clk_usb1_ctrl_root;
-    _clks[IMX8MQ_CLK_USB2_CTRL_ROOT] = &imx_clk_usb2_ctrl_root;
-    _clks[IMX8MQ_CLK_USB1_PHY_ROOT] = &imx_clk_usb1_phy_root;
-    _clks[IMX8MQ_CLK_USB2_PHY_ROOT] = &imx_clk_usb2_phy_root;
-    _clks[IMX8MQ_CLK_USDHC1_ROOT] = &imx_clk_usdhc1_root;
-    _clks[IMX8MQ_CLK_USDHC2_ROOT] = &imx_clk_usdhc2_root;
-    _clks[IMX8MQ_CLK_WDOG1_ROOT] = &imx_clk_wdog1_root;
-    _clks[IMX8MQ_CLK_WDOG2_ROOT] = &imx_clk_wdog2_root;
-    _clks[IMX8MQ_CLK_WDOG3_ROOT] = &imx_clk_wdog3_root;
-    _clks[IMX8MQ_CLK_VPU_G1_ROOT] = &imx_clk_vpu_g1_root;
-    _clks[IMX8MQ_CLK_GPU_ROOT] = &imx_clk_gpu_root;
-    _clks[IMX8MQ_CLK_VPU_G2_ROOT] = &imx_clk_vpu_g2_root;
-    _clks[IMX8MQ_CLK_DISP_ROOT] = &imx_clk_disp_root;
-    _clks[IMX8MQ_CLK_DISP_AXI_ROOT] = &imx_clk_disp_axi_root;
-    _clks[IMX8MQ_CLK_DISP_APB_ROOT] = &imx_clk_disp_apb_root;
-    _clks[IMX8MQ_CLK_DISP_RTRM_ROOT] = &imx_clk_disp_rtrm_root;
-    _clks[IMX8MQ_CLK_TMU_ROOT] = &imx_clk_tmu_root;
-    _clks[IMX8MQ_CLK_VPU_DEC_ROOT] = &imx_clk_vpu_dec_root;
-    _clks[IMX8MQ_CLK_CSI1_ROOT] = &imx_clk_csi1_root;
-    _clks[IMX8MQ_CLK_CSI2_ROOT] = &imx_clk_csi2_root;
-    _clks[IMX8MQ_CLK_SDMA1_ROOT] = &imx_clk_sdma1_root;
-    _clks[IMX8MQ_CLK_SDMA2_ROOT] = &imx_clk_sdma2_root;
-    _clks[IMX8MQ_GPT_3M_CLK] = &imx_gpt_3m_clk;
-    _clks[IMX8MQ_CLK_DRAM_ALT_ROOT] = &imx_clk_dram_alt_root;
-
-    _clks[IMX8MQ_CLK_ARM] = nullptr; /*ignore changes to core clock*/
-
-    // initialize clocks- sync internal state with hw values
-    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++) {
-        if (_clks[i] != nullptr) _clks[i]->init();
+    def_ccm(IMX8MQ_CLK_AHB, imx8mq_ahb_sels, (CCM_VA + 0x9000), true),
+    def_ccm(IMX8MQ_CLK_AUDIO_AHB, imx8mq_audio_ahb_sels, (CCM_VA + 0x9100)),
+
+    /* IPG */
+    def_div(IMX8MQ_CLK_IPG_ROOT, IMX8MQ_CLK_AHB, (CCM_VA + 0x9080), 0, 1, CLOCK_ENABLE_PARENT),
+    def_div(IMX8MQ_CLK_IPG_AUDIO_ROOT, IMX8MQ_CLK_AUDIO_AHB, (CCM_VA + 0x9180), 0, 1,
+            CLOCK_ENABLE_PARENT),
+
+    def_ccm(IMX8MQ_CLK_DRAM_ALT, imx8mq_dram_alt_sels, (CCM_VA + 0xa000)),
+    def_ccm(IMX8MQ_CLK_DRAM_APB, imx8mq_dram_apb_sels, (CCM_VA + 0xa080), true),
+    def_fixdiv(IMX8MQ_CLK_DRAM_ALT_ROOT, IMX8MQ_CLK_DRAM_ALT, 4),
+
+    def_mux(IMX8MQ_CLK_DRAM_CORE, (CCM_VA + 0x9800), 24, 1, imx8mq_dram_core_sels,
+            CLOCK_ENABLE_PARENT | CLOCK_CRITICAL),
+
+    def_ccm(IMX8MQ_CLK_VPU_G1, imx8mq_vpu_g1_sels, (CCM_VA + 0xa100)),
+    def_ccm(IMX8MQ_CLK_VPU_G2, imx8mq_vpu_g2_sels, (CCM_VA + 0xa180)),
+
+    def_ccm(IMX8MQ_CLK_DISP_DTRC, imx8mq_disp_dtrc_sels, (CCM_VA + 0xa200)),
+    def_ccm(IMX8MQ_CLK_DISP_DC8000, imx8mq_disp_dc8000_sels, (CCM_VA + 0xa280)),
+
+    def_ccm(IMX8MQ_CLK_PCIE1_CTRL, imx8mq_pcie1_ctrl_sels, (CCM_VA + 0xa300)),
+    def_ccm(IMX8MQ_CLK_PCIE1_PHY, imx8mq_pcie1_phy_sels, (CCM_VA + 0xa380)),
+    def_ccm(IMX8MQ_CLK_PCIE1_AUX, imx8mq_pcie1_aux_sels, (CCM_VA + 0xa400)),
+
+    def_ccm_any_parent(IMX8MQ_CLK_DC_PIXEL, imx8mq_dc_pixel_sels, (CCM_VA + 0xa480)),
+    def_ccm_any_parent(IMX8MQ_CLK_LCDIF_PIXEL, imx8mq_lcdif_pixel_sels, (CCM_VA + 0xa500)),
+
+    def_ccm_any_parent(IMX8MQ_CLK_SAI1, imx8mq_sai1_sels, (CCM_VA + 0xa580)),
+    def_ccm_any_parent(IMX8MQ_CLK_SAI2, imx8mq_sai2_sels, (CCM_VA + 0xa600)),
+    def_ccm_any_parent(IMX8MQ_CLK_SAI3, imx8mq_sai3_sels, (CCM_VA + 0xa680)),
+    def_ccm_any_parent(IMX8MQ_CLK_SAI4, imx8mq_sai4_sels, (CCM_VA + 0xa700)),
+    def_ccm_any_parent(IMX8MQ_CLK_SAI5, imx8mq_sai5_sels, (CCM_VA + 0xa780)),
+    def_ccm_any_parent(IMX8MQ_CLK_SAI6, imx8mq_sai6_sels, (CCM_VA + 0xa800)),
+
+    def_ccm_any_parent(IMX8MQ_CLK_SPDIF1, imx8mq_spdif1_sels, (CCM_VA + 0xa880)),
+    def_ccm_any_parent(IMX8MQ_CLK_SPDIF2, imx8mq_spdif2_sels, (CCM_VA + 0xa900)),
+
+    def_ccm(IMX8MQ_CLK_ENET_REF, imx8mq_enet_ref_sels, (CCM_VA + 0xa980)),
+    def_ccm(IMX8MQ_CLK_ENET_TIMER, imx8mq_enet_timer_sels, (CCM_VA + 0xaa00)),
+    def_ccm(IMX8MQ_CLK_ENET_PHY_REF, imx8mq_enet_phy_sels, (CCM_VA + 0xaa80)),
+
+    def_ccm(IMX8MQ_CLK_NAND, imx8mq_nand_sels, (CCM_VA + 0xab00)),
+    def_ccm(IMX8MQ_CLK_QSPI, imx8mq_qspi_sels, (CCM_VA + 0xab80)),
+
+    def_ccm(IMX8MQ_CLK_USDHC1, imx8mq_usdhc1_sels, (CCM_VA + 0xac00)),
+    def_ccm(IMX8MQ_CLK_USDHC2, imx8mq_usdhc2_sels, (CCM_VA + 0xac80)),
+
+    def_ccm(IMX8MQ_CLK_I2C1, imx8mq_i2c1_sels, (CCM_VA + 0xad00)),
+    def_ccm(IMX8MQ_CLK_I2C2, imx8mq_i2c2_sels, (CCM_VA + 0xad80)),
+    def_ccm(IMX8MQ_CLK_I2C3, imx8mq_i2c3_sels, (CCM_VA + 0xae00)),
+    def_ccm(IMX8MQ_CLK_I2C4, imx8mq_i2c4_sels, (CCM_VA + 0xae80)),
+
+    def_ccm(IMX8MQ_CLK_UART1, imx8mq_uart1_sels, (CCM_VA + 0xaf00)),
+    def_ccm(IMX8MQ_CLK_UART2, imx8mq_uart2_sels, (CCM_VA + 0xaf80)),
+    def_ccm(IMX8MQ_CLK_UART3, imx8mq_uart3_sels, (CCM_VA + 0xb000)),
+    def_ccm(IMX8MQ_CLK_UART4, imx8mq_uart4_sels, (CCM_VA + 0xb080)),
+
+    def_ccm(IMX8MQ_CLK_USB_CORE_REF, imx8mq_usb_core_sels, (CCM_VA + 0xb100)),
+    def_ccm(IMX8MQ_CLK_USB_PHY_REF, imx8mq_usb_phy_sels, (CCM_VA + 0xb180)),
+
+    def_ccm(IMX8MQ_CLK_GIC, imx8mq_gic_sels, (CCM_VA + 0xb200), true),
+
+    def_ccm(IMX8MQ_CLK_ECSPI1, imx8mq_ecspi1_sels, (CCM_VA + 0xb280)),
+    def_ccm(IMX8MQ_CLK_ECSPI2, imx8mq_ecspi2_sels, (CCM_VA + 0xb300)),
+
+    def_ccm(IMX8MQ_CLK_PWM1, imx8mq_pwm1_sels, (CCM_VA + 0xb380)),
+    def_ccm(IMX8MQ_CLK_PWM2, imx8mq_pwm2_sels, (CCM_VA + 0xb400)),
+    def_ccm(IMX8MQ_CLK_PWM3, imx8mq_pwm3_sels, (CCM_VA + 0xb480)),
+    def_ccm(IMX8MQ_CLK_PWM4, imx8mq_pwm4_sels, (CCM_VA + 0xb500)),
+
+    def_ccm(IMX8MQ_CLK_GPT1, imx8mq_gpt1_sels, (CCM_VA + 0xb580)),
+    def_ccm(IMX8MQ_CLK_WDOG, imx8mq_wdog_sels, (CCM_VA + 0xb900)),
+    def_ccm(IMX8MQ_CLK_WRCLK, imx8mq_wrclk_sels, (CCM_VA + 0xb980)),
+    def_ccm(IMX8MQ_CLK_CLKO1, imx8mq_clko1_sels, (CCM_VA + 0xba00)),
+    def_ccm(IMX8MQ_CLK_CLKO2, imx8mq_clko2_sels, (CCM_VA + 0xba80)),
+
+    def_ccm(IMX8MQ_CLK_DSI_CORE, imx8mq_dsi_core_sels, (CCM_VA + 0xbb00)),
+    def_ccm(IMX8MQ_CLK_DSI_PHY_REF, imx8mq_dsi_phy_sels, (CCM_VA + 0xbb80)),
+    def_ccm(IMX8MQ_CLK_DSI_DBI, imx8mq_dsi_dbi_sels, (CCM_VA + 0xbc00)),
+    def_ccm(IMX8MQ_CLK_DSI_ESC, imx8mq_dsi_esc_sels, (CCM_VA + 0xbc80)),
+    def_ccm(IMX8MQ_CLK_DSI_AHB, imx8mq_dsi_ahb_sels, (CCM_VA + 0x9200)),
+    def_div(IMX8MQ_CLK_DSI_IPG_DIV, IMX8MQ_CLK_DSI_AHB, (CCM_VA + 0x9280), 0, 6,
+            CLOCK_ENABLE_PARENT),
+
+    def_ccm(IMX8MQ_CLK_CSI1_CORE, imx8mq_csi1_core_sels, (CCM_VA + 0xbd00)),
+    def_ccm(IMX8MQ_CLK_CSI1_PHY_REF, imx8mq_csi1_phy_sels, (CCM_VA + 0xbd80)),
+    def_ccm(IMX8MQ_CLK_CSI1_ESC, imx8mq_csi1_esc_sels, (CCM_VA + 0xbe00)),
+    def_ccm(IMX8MQ_CLK_CSI2_CORE, imx8mq_csi2_core_sels, (CCM_VA + 0xbe80)),
+    def_ccm(IMX8MQ_CLK_CSI2_PHY_REF, imx8mq_csi2_phy_sels, (CCM_VA + 0xbf00)),
+    def_ccm(IMX8MQ_CLK_CSI2_ESC, imx8mq_csi2_esc_sels, (CCM_VA + 0xbf80)),
+
+    def_ccm(IMX8MQ_CLK_PCIE2_CTRL, imx8mq_pcie2_ctrl_sels, (CCM_VA + 0xc000)),
+    def_ccm(IMX8MQ_CLK_PCIE2_PHY, imx8mq_pcie2_phy_sels, (CCM_VA + 0xc080)),
+    def_ccm(IMX8MQ_CLK_PCIE2_AUX, imx8mq_pcie2_aux_sels, (CCM_VA + 0xc100)),
+
+    def_ccm(IMX8MQ_CLK_ECSPI3, imx8mq_ecspi3_sels, (CCM_VA + 0xc180)),
+
+    def_gate(IMX8MQ_CLK_ECSPI1_ROOT, IMX8MQ_CLK_ECSPI1, (CCM_VA + 0x4070), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_ECSPI2_ROOT, IMX8MQ_CLK_ECSPI2, (CCM_VA + 0x4080), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_ECSPI3_ROOT, IMX8MQ_CLK_ECSPI3, (CCM_VA + 0x4090), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_ENET1_ROOT, IMX8MQ_CLK_ENET_AXI, (CCM_VA + 0x40a0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_GPIO1_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x40b0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPIO2_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x40c0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPIO3_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x40d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPIO4_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x40e0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPIO5_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x40f0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_GPT1_ROOT, IMX8MQ_CLK_GPT1, (CCM_VA + 0x4100), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_I2C1_ROOT, IMX8MQ_CLK_I2C1, (CCM_VA + 0x4170), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_I2C2_ROOT, IMX8MQ_CLK_I2C2, (CCM_VA + 0x4180), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_I2C3_ROOT, IMX8MQ_CLK_I2C3, (CCM_VA + 0x4190), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_I2C4_ROOT, IMX8MQ_CLK_I2C4, (CCM_VA + 0x41a0), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_MU_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4210), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_OCOTP_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4220), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_PCIE1_ROOT, IMX8MQ_CLK_PCIE1_CTRL, (CCM_VA + 0x4250), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_PCIE2_ROOT, IMX8MQ_CLK_PCIE2_CTRL, (CCM_VA + 0x4640), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_PWM1_ROOT, IMX8MQ_CLK_PWM1, (CCM_VA + 0x4280), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_PWM2_ROOT, IMX8MQ_CLK_PWM2, (CCM_VA + 0x4290), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_PWM3_ROOT, IMX8MQ_CLK_PWM3, (CCM_VA + 0x42a0), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_PWM4_ROOT, IMX8MQ_CLK_PWM4, (CCM_VA + 0x42b0), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_QSPI_ROOT, IMX8MQ_CLK_QSPI, (CCM_VA + 0x42f0), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_RAWNAND_ROOT, IMX8MQ_CLK_NAND, (CCM_VA + 0x4300), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_NAND_USDHC_BUS_RAWNAND_CLK, IMX8MQ_CLK_NAND_USDHC_BUS, (CCM_VA + 0x4300),
+             0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_SAI1_ROOT, IMX8MQ_CLK_SAI1, (CCM_VA + 0x4330), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI1_IPG, IMX8MQ_CLK_IPG_AUDIO_ROOT, (CCM_VA + 0x4330), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_SAI2_ROOT, IMX8MQ_CLK_SAI2, (CCM_VA + 0x4340), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_SAI2_IPG, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4340), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI3_ROOT, IMX8MQ_CLK_SAI3, (CCM_VA + 0x4350), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI3_IPG, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4350), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI4_ROOT, IMX8MQ_CLK_SAI4, (CCM_VA + 0x4360), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI4_IPG, IMX8MQ_CLK_IPG_AUDIO_ROOT, (CCM_VA + 0x4360), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI5_ROOT, IMX8MQ_CLK_SAI5, (CCM_VA + 0x4370), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI5_IPG, IMX8MQ_CLK_IPG_AUDIO_ROOT, (CCM_VA + 0x4370), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI6_ROOT, IMX8MQ_CLK_SAI6, (CCM_VA + 0x4380), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SAI6_IPG, IMX8MQ_CLK_IPG_AUDIO_ROOT, (CCM_VA + 0x4380), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SNVS_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4470), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_UART1_ROOT, IMX8MQ_CLK_UART1, (CCM_VA + 0x4490), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_UART2_ROOT, IMX8MQ_CLK_UART2, (CCM_VA + 0x44a0), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_UART3_ROOT, IMX8MQ_CLK_UART3, (CCM_VA + 0x44b0), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_UART4_ROOT, IMX8MQ_CLK_UART4, (CCM_VA + 0x44c0), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_USB1_CTRL_ROOT, IMX8MQ_CLK_USB_BUS, (CCM_VA + 0x44d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_USB2_CTRL_ROOT, IMX8MQ_CLK_USB_BUS, (CCM_VA + 0x44e0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_USB1_PHY_ROOT, IMX8MQ_CLK_USB_PHY_REF, (CCM_VA + 0x44f0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_USB2_PHY_ROOT, IMX8MQ_CLK_USB_PHY_REF, (CCM_VA + 0x4500), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_USDHC1_ROOT, IMX8MQ_CLK_USDHC1, (CCM_VA + 0x4510), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_USDHC2_ROOT, IMX8MQ_CLK_USDHC2, (CCM_VA + 0x4520), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_WDOG1_ROOT, IMX8MQ_CLK_WDOG, (CCM_VA + 0x4530), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_WDOG2_ROOT, IMX8MQ_CLK_WDOG, (CCM_VA + 0x4540), 0, 3, CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_WDOG3_ROOT, IMX8MQ_CLK_WDOG, (CCM_VA + 0x4550), 0, 3, CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_VPU_G1_ROOT, IMX8MQ_CLK_VPU_G1, (CCM_VA + 0x4560), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_GPU_ROOT, IMX8MQ_CLK_GPU_CORE_DIV, (CCM_VA + 0x4570), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_VPU_G2_ROOT, IMX8MQ_CLK_VPU_G2, (CCM_VA + 0x45a0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_DISP_ROOT, IMX8MQ_CLK_DISP_DC8000, (CCM_VA + 0x45d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_DISP_AXI_ROOT, IMX8MQ_CLK_DISP_AXI, (CCM_VA + 0x45d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_DISP_APB_ROOT, IMX8MQ_CLK_DISP_APB, (CCM_VA + 0x45d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_DISP_RTRM_ROOT, IMX8MQ_CLK_DISP_RTRM, (CCM_VA + 0x45d0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_TMU_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x4620), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_VPU_DEC_ROOT, IMX8MQ_CLK_VPU_BUS, (CCM_VA + 0x4630), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_gate(IMX8MQ_CLK_CSI1_ROOT, IMX8MQ_CLK_CSI1_CORE, (CCM_VA + 0x4650), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_CSI2_ROOT, IMX8MQ_CLK_CSI2_CORE, (CCM_VA + 0x4660), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SDMA1_ROOT, IMX8MQ_CLK_IPG_ROOT, (CCM_VA + 0x43a0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+    def_gate(IMX8MQ_CLK_SDMA2_ROOT, IMX8MQ_CLK_IPG_AUDIO_ROOT, (CCM_VA + 0x43b0), 0, 3,
+             CLOCK_ENABLE_PARENT),
+
+    def_fixdiv(IMX8MQ_GPT_3M_CLK, IMX8MQ_CLK_25M, 8),
+};
+
+static constexpr uint16 NUM_CLKS = sizeof(clk_defs) / sizeof(clk_defs[0]);
+
+/* where a clock lives: slot in clk_defs and position in the pool of its kind */
+struct Clk_index {
+    uint16 slot[IMX8MQ_CLK_END]; // NUM_CLKS if the id has no clock
+    uint16 pos[IMX8MQ_CLK_END];
+    uint16 count[CLK_KINDS];
+    uint16 by_kind[CLK_KINDS][NUM_CLKS]; // slots, in table order
+};
+
+static constexpr Clk_index
+make_index(void) {
+    Clk_index idx = {};
+    for (uint16 id = 0; id < IMX8MQ_CLK_END; id++)
+        idx.slot[id] = NUM_CLKS;
+
+    for (uint16 s = 0; s < NUM_CLKS; s++) {
+        const Clk_def &def = clk_defs[s];
+        if ((def.id >= IMX8MQ_CLK_END) || (def.kind >= CLK_KINDS)) continue;
+        idx.slot[def.id] = s;
+        idx.pos[def.id] = idx.count[def.kind];
+        idx.by_kind[def.kind][idx.count[def.kind]++] = s;
+    }
+    return idx;
+}
+
+static constexpr Clk_index clk_index = make_index();
+
+/* compile-time checks of the table, each returns true if the clock in slot s is sane */
+static constexpr bool
+id_ok(uint16 s) {
+    return (clk_defs[s].id < IMX8MQ_CLK_END) && (clk_index.slot[clk_defs[s].id] == s);
+}
+
+static constexpr bool
+parents_ok(uint16 s) {
+    const Clk_def &def = clk_defs[s];
+    if (def.num_parents > MAX_PARENTS) return false;
+    for (uint8 i = 0; i < def.num_parents; i++) {
+        uint16 p = def.parents[i];
+        if ((p >= IMX8MQ_CLK_END) || (clk_index.slot[p] >= s)) return false; // parents first
+    }
+    return true;
+}
+
+static constexpr bool
+in_window(mword reg, mword base, mword size) {
+    return (reg >= base) && (reg < base + size);
+}
+
+static constexpr bool
+reg_ok(uint16 s) {
+    const Clk_def &def = clk_defs[s];
+    if ((def.kind == CLK_FIXED) || (def.kind == CLK_FIXDIV)) return def.reg == 0;
+    if ((def.reg % 4) != 0) return false;
+    return in_window(def.reg, CCM_VA, CCM_SIZE) || in_window(def.reg, ANATOP_VA, ANATOP_SIZE);
+}
+
+static constexpr bool
+field_ok(uint16 s) {
+    const Clk_def &def = clk_defs[s];
+    switch (def.kind) {
+    case CLK_FIXED:
+        return def.num_parents == 0;
+    case CLK_FIXDIV:
+        return (def.num_parents == 1) && (def.val >= 1) && (def.val <= 0xff);
+    case CLK_MUX:
+        return (def.width >= 1) && (def.width <= 3) && (def.shift + def.width <= 32)
+               && (def.num_parents >= 1) && (def.num_parents <= (1u << def.width));
+    case CLK_DIV:
+        return (def.num_parents == 1) && (def.width >= 1) && (def.shift + def.width <= 32);
+    case CLK_GATE:
+        return (def.num_parents == 1) && (def.width >= 1) && (def.width <= 2)
+               && (def.shift + def.width <= 32);
+    case CLK_FRAC_PLL:
+    case CLK_SCCG_PLL:
+        return def.num_parents == 1;
+    case CLK_CCM:
+        return (def.num_parents >= 1) && (def.num_parents <= 8);
+    default:
+        return false;
+    }
+}
+
+static constexpr bool
+all_clks(bool (*ok)(uint16)) {
+    for (uint16 s = 0; s < NUM_CLKS; s++)
+        if (!ok(s)) return false;
+    return true;
+}
+
+static_assert(all_clks(id_ok), "clock id out of range or defined twice");
+static_assert(all_clks(parents_ok), "parent not defined before its child");
+static_assert(all_clks(reg_ok), "register outside of CCM/ANATOP or not word aligned");
+static_assert(all_clks(field_ok), "bad register field or parent count");
+
+/* one statically allocated pool per kind, filled from clk_defs at compile time */
+template <class T, uint16 N>
+struct Clk_pool {
+    T clk[N];
+};
+
+template <uint16... I>
+struct Clk_seq {};
+
+template <uint16 N, uint16... I>
+struct Make_clk_seq : Make_clk_seq<N - 1, N - 1, I...> {};
+
+template <uint16... I>
+struct Make_clk_seq<0, I...> {
+    typedef Clk_seq<I...> type;
+};
+
+extern Clk_pool<Imx_fixed_clock, clk_index.count[CLK_FIXED]> imx_fixed_clks;
+extern Clk_pool<Imx_fixdiv_clock, clk_index.count[CLK_FIXDIV]> imx_fixdiv_clks;
+extern Clk_pool<Imx_clock_mux, clk_index.count[CLK_MUX]> imx_mux_clks;
+extern Clk_pool<Imx_clock_div, clk_index.count[CLK_DIV]> imx_div_clks;
+extern Clk_pool<Imx_clock_gate, clk_index.count[CLK_GATE]> imx_gate_clks;
+extern Clk_pool<Frac_pll, clk_index.count[CLK_FRAC_PLL]> imx_frac_plls;
+extern Clk_pool<Sccg_pll_clk, clk_index.count[CLK_SCCG_PLL]> imx_sccg_plls;
+extern Clk_pool<Imx_ccm_clk, clk_index.count[CLK_CCM]> imx_ccm_clks;
+
+/* object of a clock id, only the address is taken so the pools may be incomplete */
+static constexpr Clock *
+clk_ptr(uint16 id) {
+    uint16 s = clk_index.slot[id];
+    uint16 pos = clk_index.pos[id];
+    if (s >= NUM_CLKS) return nullptr;
+
+    switch (clk_defs[s].kind) {
+    case CLK_FIXED:
+        return &imx_fixed_clks.clk[pos];
+    case CLK_FIXDIV:
+        return &imx_fixdiv_clks.clk[pos];
+    case CLK_MUX:
+        return &imx_mux_clks.clk[pos];
+    case CLK_DIV:
+        return &imx_div_clks.clk[pos];
+    case CLK_GATE:
+        return &imx_gate_clks.clk[pos];
+    case CLK_FRAC_PLL:
+        return &imx_frac_plls.clk[pos];
+    case CLK_SCCG_PLL:
+        return &imx_sccg_plls.clk[pos];
+    case CLK_CCM:
+        return &imx_ccm_clks.clk[pos];
+    default:
+        return nullptr;
     }
+}
+
+static constexpr Clk_parents
+parents_of(uint16 s) {
+    Clk_parents parents = {};
+    for (uint8 i = 0; i < clk_defs[s].num_parents; i++)
+        parents.clk[i] = clk_ptr(clk_defs[s].parents[i]);
+    return parents;
+}
+
+template <class T, Clk_kind K, uint16... I>
+static constexpr Clk_pool<T, sizeof...(I)>
+make_pool(Clk_seq<I...>) {
+    return {{T(clk_defs[clk_index.by_kind[K][I]], parents_of(clk_index.by_kind[K][I]))...}};
+}
+
+template <class T, Clk_kind K>
+static constexpr Clk_pool<T, clk_index.count[K]>
+make_pool(void) {
+    return make_pool<T, K>(typename Make_clk_seq<clk_index.count[K]>::type());
+}
+
+Clk_pool<Imx_fixed_clock, clk_index.count[CLK_FIXED]> imx_fixed_clks
+    = make_pool<Imx_fixed_clock, CLK_FIXED>();
+Clk_pool<Imx_fixdiv_clock, clk_index.count[CLK_FIXDIV]> imx_fixdiv_clks
+    = make_pool<Imx_fixdiv_clock, CLK_FIXDIV>();
+Clk_pool<Imx_clock_mux, clk_index.count[CLK_MUX]> imx_mux_clks
+    = make_pool<Imx_clock_mux, CLK_MUX>();
+Clk_pool<Imx_clock_div, clk_index.count[CLK_DIV]> imx_div_clks
+    = make_pool<Imx_clock_div, CLK_DIV>();
+Clk_pool<Imx_clock_gate, clk_index.count[CLK_GATE]> imx_gate_clks
+    = make_pool<Imx_clock_gate, CLK_GATE>();
+Clk_pool<Frac_pll, clk_index.count[CLK_FRAC_PLL]> imx_frac_plls
+    = make_pool<Frac_pll, CLK_FRAC_PLL>();
+Clk_pool<Sccg_pll_clk, clk_index.count[CLK_SCCG_PLL]> imx_sccg_plls
+    = make_pool<Sccg_pll_clk, CLK_SCCG_PLL>();
+Clk_pool<Imx_ccm_clk, clk_index.count[CLK_CCM]> imx_ccm_clks = make_pool<Imx_ccm_clk, CLK_CCM>();
+
+/* first gate on the same register bit as the gate in slot s */
+static constexpr uint16
+share_of(uint16 s) {
+    const Clk_def &def = clk_defs[s];
+    if (def.kind != CLK_GATE) return def.id;
+
+    for (uint16 o = 0; o < s; o++) {
+        const Clk_def &other = clk_defs[o];
+        if ((other.kind == CLK_GATE) && (other.reg == def.reg) && (other.shift == def.shift))
+            return other.id;
+    }
+    return def.id;
+}
+
+static_assert(clk_index.count[CLK_FRAC_PLL] + clk_index.count[CLK_SCCG_PLL] < CLK_DOMAINS,
+              "one writer domain per PLL");
+
+/* PLLs are numbered from 1, Frac PLLs first */
+static constexpr uint8
+pll_domain(uint16 id) {
+    if (clk_index.slot[id] >= NUM_CLKS) return 0;
+    switch (clk_defs[clk_index.slot[id]].kind) {
+    case CLK_FRAC_PLL:
+        return static_cast<uint8>(1 + clk_index.pos[id]);
+    case CLK_SCCG_PLL:
+        return static_cast<uint8>(1 + clk_index.count[CLK_FRAC_PLL] + clk_index.pos[id]);
+    default:
+        return 0;
+    }
+}
+
+static constexpr Clk_table
+make_table(void) {
+    Clk_table table = {};
+    for (uint16 id = 0; id < IMX8MQ_CLK_END; id++) {
+        table.clk[id] = clk_ptr(id);
+        table.share[id] = (clk_index.slot[id] < NUM_CLKS) ? share_of(clk_index.slot[id]) : id;
+        table.domain[id] = pll_domain(id);
+    }
+    return table;
+}
+
+constexpr Clk_table imx_clk_table = make_table();
+
+Errno
+Imx_ClkCtrl::probe(bool lazy, const uint16 *warm, uint16 num_warm) {
+    uint64 start = Timer::now();
+    uint64 reads = imx_regs.hw_reads();
+
+    _lazy = lazy;
+    _probe_stats.clocks = 0;
+    // rates memoized by an earlier probe are stale, the hardware may have changed since
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
+        if (_clks[i] != nullptr) _clks[i]->_cache = Clock::Rate_cache();
+    build_order(); // from the table only, the subtree walks need it in both modes
+    if (lazy) {
+        // only the clocks asked for now, the rest is brought up on first use
+        for (uint16 i = 0; i < num_warm; i++)
+            if (warm[i] < IMX8MQ_CLK_END) init_clk(warm[i]);
+    } else {
+        // initialize clocks- sync internal state with hw values, parents first so that
+        // every clock finds the memoized rate of its parent
+        for (uint16 i = 0; i < _num_ordered; i++)
+            init_one(_order[i]);
+    }
+
+    _probe_stats.mmio_reads = imx_regs.hw_reads() - reads;
+    _probe_stats.ticks = Timer::now() - start;
 
     return Errno::ENONE;
 }
 
+/* depth-first over all candidate parents, a clock is appended after its parents */
+void
+Imx_ClkCtrl::build_order(void) {
+    uint8 state[IMX8MQ_CLK_END] = {}; // 0 - new, 1 - on the stack, 2 - ordered
+
+    _num_ordered = 0;
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
+        _rank[i] = 0;
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
+        visit(i, state);
+}
+
+void
+Imx_ClkCtrl::visit(uint16 id, uint8 *state) {
+    if ((_clks[id] == nullptr) || (state[id] != 0)) return;
+
+    Clock *clk = _clks[id];
+    state[id] = 1;
+    for (uint8 i = 0; i < clk->num_parents(); i++) {
+        Clock *parent = clk->parent_at(i);
+        if ((parent != nullptr) && (parent->get_id() < IMX8MQ_CLK_END))
+            visit(static_cast<uint16>(parent->get_id()), state);
+    }
+    state[id] = 2;
+    _rank[id] = _num_ordered;
+    _order[_num_ordered++] = id;
+}
+
+/**
+ * Collect root and every clock below it into _below, parents first. A clock comes after
+ * all of its candidate parents in _order, so the scan starts behind root and checks the
+ * current parent of each clock only.
+ */
+uint16
+Imx_ClkCtrl::collect_subtree(Clock *root) {
+    uint64 in[INIT_WORDS] = {};
+    uint16 num = 0, first = 0;
+
+    uint32 id = root->get_id();
+    if ((id < IMX8MQ_CLK_END) && (_clks[id] == root)) {
+        in[id / 64] |= (1ull << (id % 64));
+        _below[num++] = static_cast<uint16>(id);
+        first = static_cast<uint16>(_rank[id] + 1);
+    }
+
+    for (uint16 i = first; i < _num_ordered; i++) {
+        uint16 cid = _order[i];
+        Clock *parent = _clks[cid]->_parent;
+        if (parent == nullptr) continue;
+
+        uint32 pid = parent->get_id();
+        if ((parent == root) || ((pid < IMX8MQ_CLK_END) && ((in[pid / 64] >> (pid % 64)) & 1))) {
+            in[cid / 64] |= (1ull << (cid % 64));
+            _below[num++] = cid;
+        }
+    }
+    return num;
+}
+
+/**
+ * Lazy mode: initialize a clock on first use. All candidate parents come first, a mux
+ * only learns its selected input in init() and may be switched to any of them later.
+ */
+void
+Imx_ClkCtrl::init_clk(uint16 id) {
+    if ((_clks[id] == nullptr) || is_initialized(id)) return;
+
+    Clock *clk = _clks[id];
+    set_initialized(id); // before the parents, stops the recursion on a loop
+    for (uint8 i = 0; i < clk->num_parents(); i++) {
+        Clock *parent = clk->parent_at(i);
+        if ((parent != nullptr) && (parent->get_id() < IMX8MQ_CLK_END))
+            init_clk(static_cast<uint16>(parent->get_id()));
+    }
+
+    init_one(id);
+}
+
+/* sync one clock whose parents are synced, see the reference policy at put_ref */
+void
+Imx_ClkCtrl::init_one(uint16 id) {
+    Clock *clk = _clks[id];
+    uint32 rate;
+
+    clk->init();
+    cached_rate(clk, rate);
+    set_initialized(id);
+    _probe_stats.clocks++;
+
+    if (clk->_flags & CLOCK_CRITICAL) {
+        get_ref(clk);
+        publish_subtree(ref_top(clk, 1));
+        return;
+    }
+
+    // a boot reference changes no state, everything up to the root already runs
+    if (has_gate(clk) && clk->running()) get_ref(clk);
+    publish(clk);
+}
+
+/* common entry check, brings the clock up in lazy mode */
 Errno
-Imx_ClkCtrl::enable_clk(uint64 clk_id) {
-    if (clk_id > IMX8MQ_CLK_END) return Errno::EINVAL;
+Imx_ClkCtrl::lookup(uint64 clk_id, Clock *&clk) {
+    if (clk_id >= IMX8MQ_CLK_END) return Errno::EINVAL;
     if (_clks[clk_id] == nullptr) return Errno::ENOTSUP;
 
-    return _clks[clk_id]->enable() ? Errno::ENONE : Errno::EINVAL;
+    if (_lazy) init_clk(static_cast<uint16>(clk_id));
+    clk = _clks[clk_id];
+    return Errno::ENONE;
+}
+
+Errno
+Imx_ClkCtrl::enable_clk(uint64 clk_id) {
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+
+    err = get_ref(clk);
+    publish_subtree(ref_top(clk, (err == Errno::ENONE) ? 1 : 0));
+    return err;
 }
 
 Errno
 Imx_ClkCtrl::get_clkrate(uint64 clk_id, uint64& value) {
-    if (clk_id > IMX8MQ_CLK_END) return Errno::EINVAL;
-    if (_clks[clk_id] == nullptr) return Errno::ENOTSUP;
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
 
     uint32 rate;
-    if (_clks[clk_id]->get_rate(rate)) {
+    if (cached_rate(clk, rate)) {
         value = static_cast<uint64>(rate);
         return Errno::ENONE;
     } else
@@ -1165,21 +1278,167 @@ Imx_ClkCtrl::get_clkrate(uint64 clk_id, uint64& value) {
 
 Errno
 Imx_ClkCtrl::disable_clk(uint64 clk_id) {
-    if (clk_id > IMX8MQ_CLK_END) return Errno::EINVAL;
-    if (_clks[clk_id] == nullptr) return Errno::ENOTSUP;
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
 
-    return _clks[clk_id]->disable() ? Errno::ENONE : Errno::EINVAL;
+    err = put_ref(clk);
+    publish_subtree(ref_top(clk, 0));
+    return err;
 }
 
 Errno
 Imx_ClkCtrl::set_clkrate(uint64 clk_id, uint64 value) {
-    if (clk_id > IMX8MQ_CLK_END) return Errno::EINVAL;
-    if (_clks[clk_id] == nullptr) return Errno::ENOTSUP;
+    uint64 parent_id;
+    Errno err = rate_parent(clk_id, value, parent_id);
+    if (err == Errno::ENONE) return set_clkrate(clk_id, value, parent_id);
+    if (err != Errno::ENOTSUP) return err;
+
+    Clock *clk;
+    err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+    return set_rate(clk, static_cast<uint32>(value));
+}
+
+/**
+ * Rate change of a CLOCK_CHANGE_RATE_PARENT clock from parent_id, see rate_parent. The
+ * switch is one write of the target root, a running clock references its new parent
+ * before and releases the old one after, as with configure.
+ */
+Errno
+Imx_ClkCtrl::set_clkrate(uint64 clk_id, uint64 value, uint64 parent_id) {
+    Clock *clk, *parent;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+    err = lookup(parent_id, parent);
+    if (err != Errno::ENONE) return err;
+    if ((clk->kind() != CLK_CCM) || !(clk->_flags & CLOCK_CHANGE_RATE_PARENT))
+        return Errno::ENOTSUP;
+
+    Clock *old = clk->_parent;
+    if (parent == old) return set_rate(clk, static_cast<uint32>(value));
+
+    Imx_ccm_clk *ccm = static_cast<Imx_ccm_clk *>(clk);
+    bool running = _refs[clk->get_id()] > 0;
+    if (running) {
+        err = get_ref(parent);
+        if (err != Errno::ENONE) return err;
+    }
+
+    if (!ccm->configure(parent, static_cast<uint32>(value), Clk_ops::is_enabled(clk))) {
+        if (running) put_ref(parent);
+        return failure(clk, clk);
+    }
+    if (running) put_ref(old);
 
-    uint32 rate = static_cast<uint32>(value);
-    if (_clks[clk_id]->set_rate(rate))
+    invalidate_rates(clk);
+    if (old != nullptr) publish_subtree(ref_top(old, 0));
+    publish_subtree(ref_top(clk, running ? 1 : 0));
+    return Errno::ENONE;
+}
+
+Errno
+Imx_ClkCtrl::rate_parent(uint64 clk_id, uint64 value, uint64 &parent_id) {
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+    if ((clk->kind() != CLK_CCM) || !(clk->_flags & CLOCK_CHANGE_RATE_PARENT))
+        return Errno::ENOTSUP;
+
+    Clock *parent;
+    uint32 achieved;
+    if (!static_cast<Imx_ccm_clk *>(clk)->best_parent(static_cast<uint32>(value), parent, achieved))
+        return Errno::EINVAL;
+    parent_id = parent->get_id();
+    return Errno::ENONE;
+}
+
+/* rate change on the current parent */
+Errno
+Imx_ClkCtrl::set_rate(Clock *clk, uint32 rate) {
+    // a forwarded rate change retunes the parent, and with it all of its children
+    Clock *root = clk;
+    while (root->propagates_rate() && (root->_parent != nullptr))
+        root = root->_parent;
+
+    bool ok = Clk_ops::set_rate(clk, rate);
+    invalidate_rates(root); // also on failure, the change may be partially applied
+    publish_subtree(root);
+
+    return ok ? Errno::ENONE : failure(clk, root);
+}
+
+/**
+ * Reparent, retune and gate a CCM clock with one register write. A running clock gets its
+ * new parent referenced before it switches over and releases the old one after, the
+ * references of the clock itself change as with enable_clk and disable_clk.
+ */
+Errno
+Imx_ClkCtrl::configure(uint64 clk_id, uint64 parent_id, uint64 rate, uint32 flags) {
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+    if (clk->kind() != CLK_CCM) return Errno::ENOTSUP;
+
+    bool on = flags & drv_ipc::CLK_CONFIG_ENABLE;
+    bool off = flags & drv_ipc::CLK_CONFIG_DISABLE;
+    if (on && off) return Errno::EINVAL;
+
+    Clock *old = clk->_parent;
+    Clock *parent = old;
+    if (flags & drv_ipc::CLK_CONFIG_PARENT) {
+        err = lookup(parent_id, parent);
+        if (err != Errno::ENONE) return err;
+    }
+
+    Imx_ccm_clk *ccm = static_cast<Imx_ccm_clk *>(clk);
+    uint16 id = static_cast<uint16>(clk->get_id());
+    if (on && (_refs[id] == __UINT16_MAX__)) return Errno::EOVERFLOW;
+    if (off && (_refs[id] == 0)) return Errno::EINVAL; // unbalanced disable
+
+    bool was_running = _refs[id] > 0;
+    bool running = on || (was_running && !(off && (_refs[id] == 1)));
+    if (was_running && !running && ccm->is_critical()) return Errno::EBUSY;
+
+    // the new parent runs before the clock switches over to it
+    bool take = running && (!was_running || (parent != old));
+    if (take) {
+        err = get_ref(parent);
+        if (err != Errno::ENONE) return err;
+    }
+
+    uint32 target = (flags & drv_ipc::CLK_CONFIG_RATE) ? static_cast<uint32>(rate) : 0;
+    if (!ccm->configure(parent, target, running)) {
+        if (take) put_ref(parent);
+        return failure(clk, clk);
+    }
+
+    uint16 share = imx_clk_table.share[id];
+    if (on) _refs[id]++;
+    if (off) _refs[id]--;
+    if (!was_running && running) _share_refs[share]++;
+    if (was_running && !running) _share_refs[share]--;
+
+    // released after the switch
+    if (was_running && (!running || (parent != old))) put_ref(old);
+
+    invalidate_rates(clk);
+    if (old != nullptr) publish_subtree(ref_top(old, 0));
+    publish_subtree(ref_top(clk, running ? 1 : 0));
+    return Errno::ENONE;
+}
+
+Errno
+Imx_ClkCtrl::round_clkrate(uint64 clk_id, uint64 value, uint64& rounded) {
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+
+    uint32 rate;
+    if (Clk_ops::round_rate(clk, static_cast<uint32>(value), rate)) {
+        rounded = static_cast<uint64>(rate);
         return Errno::ENONE;
-    else
+    } else
         return Errno::EINVAL;
 }
 
@@ -1190,14 +1449,400 @@ Imx_ClkCtrl::get_max_clkid(void) {
 
 Errno
 Imx_ClkCtrl::describe_clkrate(uint64 clk_id, Pm::clk_desc& rate) {
-    if (clk_id > IMX8MQ_CLK_END) return Errno::EINVAL;
-    if (_clks[clk_id] == nullptr) return Errno::ENOTSUP;
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
 
-    return _clks[clk_id]->describe_rate(rate) ? Errno::ENONE : Errno::EINVAL;
+    return clk->describe_rate(rate) ? Errno::ENONE : Errno::EINVAL;
 }
 
 bool
 Imx_ClkCtrl::is_enabled(uint64 clk_id) {
-    if ((clk_id > IMX8MQ_CLK_END) || (_clks[clk_id] == nullptr)) return false;
-    return _clks[clk_id]->is_enabled();
-}
\ No newline at end of file
+    Clock *clk;
+    if (lookup(clk_id, clk) != Errno::ENONE) return false;
+    return Clk_ops::is_enabled(clk);
+}
+
+Errno
+Imx_ClkCtrl::lock_stats(uint64 clk_id, Pll_lock::Stats &stats) {
+    Clock *clk;
+    Errno err = lookup(clk_id, clk);
+    if (err != Errno::ENONE) return err;
+
+    const Pll_lock::Stats *lock = clk->lock_stats();
+    if (lock == nullptr) return Errno::ENOTSUP;
+    stats = *lock;
+    return Errno::ENONE;
+}
+
+uint8
+Imx_ClkCtrl::domain_of(uint64 clk_id) {
+    Clock *clk;
+    if (lookup(clk_id, clk) != Errno::ENONE) return 0;
+
+    for (; clk != nullptr; clk = clk->_parent) {
+        uint8 domain = imx_clk_table.domain[clk->get_id()];
+        if (domain != 0) return domain;
+    }
+    return 0;
+}
+
+/**
+ * Error of a failed operation on clk, which may have been forwarded up to root. The
+ * first specific error on the way is reported, EINVAL if there is none.
+ */
+Errno
+Imx_ClkCtrl::failure(Clock *clk, Clock *root) {
+    Errno err = Errno::EINVAL;
+    for (Clock *c = clk; c != nullptr; c = c->_parent) {
+        Errno e = c->take_error();
+        if ((e != Errno::ENONE) && (err == Errno::EINVAL)) err = e;
+        if (c == root) break;
+    }
+    return err;
+}
+
+/**
+ * Take a reference on a clock. The first reference enables the parent chain and then
+ * the clock itself, gates sharing an enable bit are counted together.
+ */
+Errno
+Imx_ClkCtrl::get_ref(Clock *clk) {
+    uint16 id = static_cast<uint16>(clk->get_id());
+    if (_refs[id] == __UINT16_MAX__) return Errno::EOVERFLOW;
+    if (_refs[id]++ > 0) return Errno::ENONE;
+
+    Clock *parent = clk->_parent;
+    if (parent != nullptr) {
+        Errno err = get_ref(parent);
+        if (err != Errno::ENONE) {
+            _refs[id]--;
+            return err;
+        }
+    }
+
+    uint16 share = imx_clk_table.share[id];
+    if (has_gate(clk)) _share_refs[share]++;
+    if (!Clk_ops::enable(clk)) {
+        if (has_gate(clk)) _share_refs[share]--;
+        if (parent != nullptr) put_ref(parent);
+        _refs[id]--;
+        return failure(clk, clk);
+    }
+    return Errno::ENONE;
+}
+
+/**
+ * Drop a reference on a clock. The last reference gates the clock, unless another gate
+ * on the same bit is in use, and then releases the parent chain up to the PLL.
+ *
+ * Critical clocks are pinned with a reference at probe. Every gate found running then
+ * holds a boot reference too, on behalf of whoever enabled it before us. A client can
+ * disable such a clock to gate an idle IP. The gate's ancestors that were running keep
+ * their own boot references, so they stay on for the other boot-time users.
+ */
+Errno
+Imx_ClkCtrl::put_ref(Clock *clk) {
+    uint16 id = static_cast<uint16>(clk->get_id());
+    if (_refs[id] == 0) return Errno::EINVAL; // unbalanced disable
+    if (--_refs[id] > 0) return Errno::ENONE;
+
+    Clock *parent = clk->_parent;
+    if (has_gate(clk)) {
+        uint16 share = imx_clk_table.share[id];
+        if ((--_share_refs[share] == 0) && !Clk_ops::disable(clk)) {
+            // still running, keep the reference and with it the parents
+            _share_refs[share]++;
+            _refs[id]++;
+            return Errno::EBUSY;
+        }
+    }
+
+    if (parent != nullptr) {
+        put_ref(parent);
+        // without a gate of its own the clock runs as long as its parent does
+        if (!has_gate(clk)) clk->_enabled = Clk_ops::is_enabled(parent);
+    }
+    return Errno::ENONE;
+}
+
+bool
+Imx_ClkCtrl::cached_rate(Clock *clk, uint32 &rate) {
+    Clock::Rate_cache &cache = clk->_cache;
+    if (cache.valid()) {
+        rate = cache.rate;
+        return true;
+    }
+
+    if (!Clk_ops::get_rate(clk, rate)) return false;
+    cache.rate = rate;
+    cache.gen = _generation;
+    return true;
+}
+
+/* Start a new generation and mark every clock below (and including) root as stale */
+void
+Imx_ClkCtrl::invalidate_rates(Clock *root) {
+    if (++_generation == 0) {
+        // wrapped: forget all cached rates and start over
+        for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
+            if (_clks[i] != nullptr) _clks[i]->_cache = Clock::Rate_cache();
+        _generation = 1;
+    }
+
+    uint16 num = collect_subtree(root);
+    for (uint16 i = 0; i < num; i++)
+        _clks[_below[i]]->_cache.stale = _generation;
+}
+
+/* snapshot the clock for read_state, called with the tree locked after every change */
+void
+Imx_ClkCtrl::publish(Clock *clk) {
+    uint16 id = static_cast<uint16>(clk->get_id());
+    Clk_state old;
+    bool known = read_state(id, old) && (old.flags & Clk_state::RATE);
+    Clk_state state = {};
+
+    state.flags = Clk_state::VALID;
+    if (cached_rate(clk, state.rate)) state.flags |= Clk_state::RATE;
+    if (clk->describe_rate(state.desc)) state.flags |= Clk_state::DESC;
+    if (Clk_ops::is_enabled(clk)) state.flags |= Clk_state::ENABLED;
+
+    state.parent = Clk_state::NO_PARENT;
+    for (uint8 i = 0; (clk->_parent != nullptr) && (i < clk->num_parents()); i++) {
+        if (clk->parent_at(i) == clk->_parent) {
+            state.parent = i;
+            break;
+        }
+    }
+
+    _state[id].write(state);
+    if (_status != nullptr) update_status(clk, state);
+
+    if (known && (!(state.flags & Clk_state::RATE) || (state.rate != old.rate))) rate_changed(id);
+}
+
+uint32
+Imx_ClkCtrl::clk_stats(uint32 cursor, drv_ipc::clk_stats_rec *recs, uint32 max_recs,
+                       uint32 &num_recs) {
+    uint32 id = cursor;
+    num_recs = 0;
+    for (; (id < IMX8MQ_CLK_END) && (num_recs < max_recs); id++) {
+        Clock *clk = _clks[id];
+        if (clk == nullptr) continue;
+
+        drv_ipc::clk_stats_rec &rec = recs[num_recs++];
+        rec = {};
+        rec.id = static_cast<uint16>(id);
+        rec.mmio_reads = clk->_mmio_reads;
+        rec.mmio_writes = clk->_mmio_writes;
+
+        const Pll_lock::Stats *lock = clk->lock_stats();
+        if (lock != nullptr) {
+            rec.mmio_reads += lock->polls;
+            rec.pll_waits = lock->locks + lock->timeouts;
+            rec.pll_wait_ticks = lock->wait_ticks;
+        }
+    }
+    return id;
+}
+
+void
+Imx_ClkCtrl::reset_stats(void) {
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++) {
+        Clock *clk = _clks[i];
+        if (clk == nullptr) continue;
+        clk->_mmio_reads = clk->_mmio_writes = 0;
+        clk->reset_lock_stats();
+    }
+    imx_regs.reset_stats();
+#if IMX_MMIO_TRACE
+    mmio_trace.clear();
+#endif
+}
+
+Errno
+Imx_ClkCtrl::mmio_stats(uint32 &cursor, drv_ipc::mmio_stats_rec *recs, uint32 max_recs,
+                        uint32 &num_recs) {
+    num_recs = 0;
+#if IMX_MMIO_TRACE
+    drv_ipc::mmio_stats_rec all[CLK_KINDS];
+    mmio_trace.report(all, CLK_KINDS);
+    for (; (cursor < CLK_KINDS) && (num_recs < max_recs); cursor++)
+        recs[num_recs++] = all[cursor];
+    return Errno::ENONE;
+#else
+    (void)cursor, (void)recs, (void)max_recs;
+    return Errno::ENOTSUP;
+#endif
+}
+
+uint32
+Imx_ClkCtrl::dump(uint32 cursor, drv_ipc::clk_dump_rec *recs, uint32 max_recs,
+                  uint32 &num_recs) const {
+    uint32 id = cursor;
+    num_recs = 0;
+    for (; (id < IMX8MQ_CLK_END) && (num_recs < max_recs); id++) {
+        Clock *clk = _clks[id];
+        if (clk == nullptr) continue;
+
+        drv_ipc::clk_dump_rec &rec = recs[num_recs++];
+        rec = {};
+        rec.id = static_cast<uint16>(id);
+        rec.kind = clk->kind();
+        rec.parent = drv_ipc::clk_status_page::NO_PARENT;
+
+        Clk_state state;
+        if (!read_state(id, state)) continue;
+        rec.flags = drv_ipc::clk_dump_rec::VALID;
+        if (state.flags & Clk_state::RATE) {
+            rec.flags |= drv_ipc::clk_dump_rec::RATE;
+            rec.rate = state.rate;
+        }
+        if (state.flags & Clk_state::ENABLED) rec.flags |= drv_ipc::clk_dump_rec::ENABLED;
+        if (state.parent != Clk_state::NO_PARENT) {
+            Clock *parent = clk->parent_at(state.parent); // candidates never change
+            if (parent != nullptr) rec.parent = static_cast<uint16>(parent->get_id());
+        }
+    }
+    return id;
+}
+
+void
+Imx_ClkCtrl::attach_status(drv_ipc::clk_status_page *page) {
+    page->version = drv_ipc::clk_status_page::VERSION;
+    page->num_clks = IMX8MQ_CLK_END;
+    page->gen = 0;
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++)
+        page->clk[i] = {0, drv_ipc::clk_status_page::NO_PARENT, 0, 0};
+    _status = page;
+
+    // clocks synced before the page was there
+    for (uint16 i = 0; i < IMX8MQ_CLK_END; i++) {
+        Clk_state state;
+        if (read_state(i, state)) update_status(_clks[i], state);
+    }
+}
+
+/* same protocol as Seq_value, with one generation for the whole page */
+void
+Imx_ClkCtrl::update_status(const Clock *clk, const Clk_state &state) {
+    drv_ipc::clk_status_page::entry e = {};
+    e.flags = drv_ipc::clk_status_page::VALID;
+    if (state.flags & Clk_state::RATE) {
+        e.flags |= drv_ipc::clk_status_page::RATE;
+        e.rate = state.rate;
+    }
+    if (state.flags & Clk_state::ENABLED) e.flags |= drv_ipc::clk_status_page::ENABLED;
+    e.parent = (clk->_parent != nullptr) ? static_cast<uint16>(clk->_parent->_id)
+                                         : drv_ipc::clk_status_page::NO_PARENT;
+
+    uint32 words[sizeof(e) / sizeof(uint32)];
+    __builtin_memcpy(words, &e, sizeof(e));
+    uint32 *dst = reinterpret_cast<uint32 *>(&_status->clk[clk->_id]);
+
+    uint32 gen = _status->gen;
+    __atomic_store_n(&_status->gen, gen + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (uint8 i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        __atomic_store_n(&dst[i], words[i], __ATOMIC_RELAXED);
+    __atomic_store_n(&_status->gen, gen + 2, __ATOMIC_RELEASE);
+}
+
+/* every synced clock below (and including) root, parents first */
+void
+Imx_ClkCtrl::publish_subtree(Clock *root) {
+    uint16 num = collect_subtree(root);
+    for (uint16 i = 0; i < num; i++)
+        if (is_initialized(_below[i])) publish(_clks[_below[i]]);
+}
+
+/**
+ * Topmost clock a reference change on clk may have switched. The ancestors whose count
+ * went from 0 to 1 (or back to 0) all hold refs now, the first one that does not is
+ * unaffected.
+ */
+Clock *
+Imx_ClkCtrl::ref_top(Clock *clk, uint16 refs) {
+    while ((clk->_parent != nullptr) && (_refs[clk->_parent->get_id()] == refs))
+        clk = clk->_parent;
+    return clk;
+}
+
+Errno
+Imx_ClkCtrl::subscribe(const uint16 *ids, uint32 num_ids, mword sem, uint32 &sub_id) {
+    for (uint32 i = 0; i < num_ids; i++) {
+        Clock *clk;
+        Errno err = lookup(ids[i], clk); // syncs the clock, changes are seen from now on
+        if (err != Errno::ENONE) return err;
+    }
+
+    Clk_sub *sub = nullptr;
+    for (uint16 i = 0; (sub == nullptr) && (i < CLK_SUBSCRIBERS); i++)
+        if (_subs[i].id == 0) sub = &_subs[i];
+    if (sub == nullptr) return Errno::EBUSY;
+
+    if (++_next_sub == 0) _next_sub = 1; // 0 marks a free slot
+    sub->id = _next_sub;
+    sub->sem = sem;
+    sub->pending = false;
+    for (uint16 w = 0; w < drv_ipc::CLK_ID_WORDS; w++)
+        sub->watch[w] = sub->changed[w] = 0;
+    for (uint32 i = 0; i < num_ids; i++)
+        sub->watch[ids[i] / 64] |= (1ull << (ids[i] % 64));
+
+    sub_id = sub->id;
+    return Errno::ENONE;
+}
+
+Errno
+Imx_ClkCtrl::unsubscribe(uint32 sub_id) {
+    for (uint16 i = 0; i < CLK_SUBSCRIBERS; i++) {
+        if ((sub_id != 0) && (_subs[i].id == sub_id)) {
+            _subs[i].id = 0;
+            return Errno::ENONE;
+        }
+    }
+    return Errno::EINVAL;
+}
+
+Errno
+Imx_ClkCtrl::take_changes(uint32 sub_id, uint64 *changed) {
+    for (uint16 i = 0; i < CLK_SUBSCRIBERS; i++) {
+        Clk_sub &sub = _subs[i];
+        if ((sub_id == 0) || (sub.id != sub_id)) continue;
+
+        for (uint16 w = 0; w < drv_ipc::CLK_ID_WORDS; w++) {
+            changed[w] = sub.changed[w];
+            sub.changed[w] = 0;
+        }
+        return Errno::ENONE;
+    }
+    return Errno::EINVAL;
+}
+
+/* the caller signals, so that every request results in at most one signal per subscriber */
+bool
+Imx_ClkCtrl::next_notification(mword &sem) {
+    for (uint16 i = 0; i < CLK_SUBSCRIBERS; i++) {
+        Clk_sub &sub = _subs[i];
+        if ((sub.id != 0) && sub.pending) {
+            sub.pending = false;
+            sem = sub.sem;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* called from publish, so every clock below a changed one is covered */
+void
+Imx_ClkCtrl::rate_changed(uint16 id) {
+    uint64 bit = 1ull << (id % 64);
+    for (uint16 i = 0; i < CLK_SUBSCRIBERS; i++) {
+        Clk_sub &sub = _subs[i];
+        if ((sub.id == 0) || !(sub.watch[id / 64] & bit)) continue;
+        sub.changed[id / 64] |= bit;
+        sub.pending = true;
+    }
+}
@@ -6,21 +6,46 @@
 
 #include <imx8mq.hpp>
 #include <pebble/pebble.hpp>
+#include <stats.hpp>
+#include <timer.hpp>
 
 static Imx8mq drv;
+static Portal_stats portal_stats;
 
-/*get our UTCB mapped here*/
+/* shared read-only with the clients, see drv_ipc::clk_status_page */
+static drv_ipc::clk_status_page status_page;
+
+/*get our UTCBs mapped here, one per service EC, then the worker's*/
 static mword UTCB_BASE = (DEV_MMIO_END + PAGE_SIZE);
+static mword WORKER_UTCB_BASE = (UTCB_BASE + SRV_CPUS * PAGE_SIZE);
+
+static inline mword
+srv_utcb_va(Cpu cpu) {
+    return UTCB_BASE + cpu * PAGE_SIZE;
+}
+
+/* wakes the async worker, one up per queued request */
+static Sel worker_sm;
 
-PBL_PORTAL(imx8mq_srv, mword, Mtd, Pbl::Utcb *) {
-    drv_ipc::header *hdr = reinterpret_cast<drv_ipc::header *>(UTCB_BASE);
+/* signal the subscribers whose clocks changed rate in the last request */
+static void
+notify_changes(Pbl::Utcb *utcb) {
+    mword sem;
+    while (drv.next_notification(sem))
+        Pbl::sm_up(utcb, sem);
+}
+
+/* handle the request in msg, returns the size of the reply in words */
+static mword
+dispatch(Pbl::Utcb *utcb, mword msg) {
+    drv_ipc::header *hdr = reinterpret_cast<drv_ipc::header *>(msg);
 
     switch (hdr->id) {
     case drv_ipc::method::CLK_IS_ENABLED: {
         drv_ipc::clk_is_enabled_args *in
-            = reinterpret_cast<drv_ipc::clk_is_enabled_args *>(UTCB_BASE);
+            = reinterpret_cast<drv_ipc::clk_is_enabled_args *>(msg);
         drv_ipc::clk_is_enabled_ret *out
-            = reinterpret_cast<drv_ipc::clk_is_enabled_ret *>(UTCB_BASE);
+            = reinterpret_cast<drv_ipc::clk_is_enabled_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
@@ -29,37 +54,47 @@ PBL_PORTAL(imx8mq_srv, mword, Mtd, Pbl::Utcb *) {
             out->enabled = 1;
         else
             out->enabled = 0;
+        out->errno = ENONE;
         return out->size();
     }
     case drv_ipc::method::CLK_GET_MAX: {
-        drv_ipc::clk_get_max_ret *out = reinterpret_cast<drv_ipc::clk_get_max_ret *>(UTCB_BASE);
+        drv_ipc::clk_get_max_ret *out = reinterpret_cast<drv_ipc::clk_get_max_ret *>(msg);
         out->max_id = drv.get_max_clkid();
         out->errno = ENONE;
         return out->size();
     }
     case drv_ipc::method::CLK_ENABLE: {
-        drv_ipc::clk_enable_args *in = reinterpret_cast<drv_ipc::clk_enable_args *>(UTCB_BASE);
-        drv_ipc::clk_enable_ret *out = reinterpret_cast<drv_ipc::clk_enable_ret *>(UTCB_BASE);
+        drv_ipc::clk_enable_args *in = reinterpret_cast<drv_ipc::clk_enable_args *>(msg);
+        drv_ipc::clk_enable_ret *out = reinterpret_cast<drv_ipc::clk_enable_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
         }
+        if (in->flags & drv_ipc::CLK_ASYNC) {
+            uint32 ticket = 0;
+            out->errno = drv.submit(drv_ipc::method::CLK_ENABLE, in->clk_id, 0, in->sem, ticket);
+            out->ticket = ticket;
+            if (out->errno == EINPROGRESS) Pbl::sm_up(utcb, worker_sm);
+            return out->size();
+        }
         out->errno = drv.enable_clk(in->clk_id);
+        notify_changes(utcb);
         return out->size();
     }
     case drv_ipc::method::CLK_DISABLE: {
-        drv_ipc::clk_disable_args *in = reinterpret_cast<drv_ipc::clk_disable_args *>(UTCB_BASE);
-        drv_ipc::clk_disable_ret *out = reinterpret_cast<drv_ipc::clk_disable_ret *>(UTCB_BASE);
+        drv_ipc::clk_disable_args *in = reinterpret_cast<drv_ipc::clk_disable_args *>(msg);
+        drv_ipc::clk_disable_ret *out = reinterpret_cast<drv_ipc::clk_disable_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
         }
         out->errno = drv.disable_clk(in->clk_id);
+        notify_changes(utcb);
         return out->size();
     }
     case drv_ipc::method::CLK_GET_RATE: {
-        drv_ipc::clk_get_rate_args *in = reinterpret_cast<drv_ipc::clk_get_rate_args *>(UTCB_BASE);
-        drv_ipc::clk_get_rate_ret *out = reinterpret_cast<drv_ipc::clk_get_rate_ret *>(UTCB_BASE);
+        drv_ipc::clk_get_rate_args *in = reinterpret_cast<drv_ipc::clk_get_rate_args *>(msg);
+        drv_ipc::clk_get_rate_ret *out = reinterpret_cast<drv_ipc::clk_get_rate_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
@@ -68,20 +103,65 @@ PBL_PORTAL(imx8mq_srv, mword, Mtd, Pbl::Utcb *) {
         return out->size();
     }
     case drv_ipc::method::CLK_SET_RATE: {
-        drv_ipc::clk_set_rate_args *in = reinterpret_cast<drv_ipc::clk_set_rate_args *>(UTCB_BASE);
-        drv_ipc::clk_set_rate_ret *out = reinterpret_cast<drv_ipc::clk_set_rate_ret *>(UTCB_BASE);
+        drv_ipc::clk_set_rate_args *in = reinterpret_cast<drv_ipc::clk_set_rate_args *>(msg);
+        drv_ipc::clk_set_rate_ret *out = reinterpret_cast<drv_ipc::clk_set_rate_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
         }
+        if (in->flags & drv_ipc::CLK_ASYNC) {
+            uint32 ticket = 0;
+            out->errno
+                = drv.submit(drv_ipc::method::CLK_SET_RATE, in->clk_id, in->rate, in->sem, ticket);
+            out->ticket = ticket;
+            if (out->errno == EINPROGRESS) Pbl::sm_up(utcb, worker_sm);
+            return out->size();
+        }
         out->errno = drv.set_clkrate(in->clk_id, in->rate);
+        notify_changes(utcb);
+        return out->size();
+    }
+    case drv_ipc::method::CLK_CONFIGURE: {
+        drv_ipc::clk_configure_args *in = reinterpret_cast<drv_ipc::clk_configure_args *>(msg);
+        drv_ipc::clk_configure_ret *out = reinterpret_cast<drv_ipc::clk_configure_ret *>(msg);
+        uint64 clk_id = in->clk_id;
+        if (!drv.is_clk_valid(clk_id)) {
+            out->errno = EINVAL;
+            return out->size();
+        }
+        Errno err = drv.configure(clk_id, in->parent_id, in->rate, in->flags);
+        notify_changes(utcb);
+        uint64 rate = 0;
+        drv.get_clkrate(clk_id, rate);
+        out->errno = err;
+        out->rate = rate;
+        return out->size();
+    }
+    case drv_ipc::method::CLK_ASYNC_STATUS: {
+        drv_ipc::clk_async_status_args *in
+            = reinterpret_cast<drv_ipc::clk_async_status_args *>(msg);
+        drv_ipc::clk_async_status_ret *out
+            = reinterpret_cast<drv_ipc::clk_async_status_ret *>(msg);
+        out->errno = drv.async_status(in->ticket);
+        return out->size();
+    }
+    case drv_ipc::method::CLK_ROUND_RATE: {
+        drv_ipc::clk_round_rate_args *in
+            = reinterpret_cast<drv_ipc::clk_round_rate_args *>(msg);
+        drv_ipc::clk_round_rate_ret *out
+            = reinterpret_cast<drv_ipc::clk_round_rate_ret *>(msg);
+        if (!drv.is_clk_valid(in->clk_id)) {
+            out->errno = EINVAL;
+            return out->size();
+        }
+        out->errno = drv.round_clkrate(in->clk_id, in->rate, out->rate);
         return out->size();
     }
     case drv_ipc::method::CLK_DESCRIBE_RATE: {
         drv_ipc::clk_describe_rate_args *in
-            = reinterpret_cast<drv_ipc::clk_describe_rate_args *>(UTCB_BASE);
+            = reinterpret_cast<drv_ipc::clk_describe_rate_args *>(msg);
         drv_ipc::clk_describe_rate_ret *out
-            = reinterpret_cast<drv_ipc::clk_describe_rate_ret *>(UTCB_BASE);
+            = reinterpret_cast<drv_ipc::clk_describe_rate_ret *>(msg);
         if (!drv.is_clk_valid(in->clk_id)) {
             out->errno = EINVAL;
             return out->size();
@@ -89,10 +169,106 @@ PBL_PORTAL(imx8mq_srv, mword, Mtd, Pbl::Utcb *) {
         out->errno = drv.describe_clkrate(in->clk_id, out->desc);
         return out->size();
     }
+    case drv_ipc::method::CLK_BATCH: {
+        drv_ipc::clk_batch_args *in = reinterpret_cast<drv_ipc::clk_batch_args *>(msg);
+        drv_ipc::clk_batch_ret *out = reinterpret_cast<drv_ipc::clk_batch_ret *>(msg);
+        if (in->num_ops > drv_ipc::clk_batch_args::max_ops()) {
+            out->errno = EINVAL;
+            out->num_ops = 0;
+            return out->size();
+        }
+        drv.run_batch(in->ops, in->num_ops);
+        notify_changes(utcb);
+        out->errno = ENONE;
+        return out->size();
+    }
+    case drv_ipc::method::CLK_SUBSCRIBE: {
+        drv_ipc::clk_subscribe_args *in = reinterpret_cast<drv_ipc::clk_subscribe_args *>(msg);
+        drv_ipc::clk_subscribe_ret *out = reinterpret_cast<drv_ipc::clk_subscribe_ret *>(msg);
+        if (in->num_ids > drv_ipc::clk_subscribe_args::max_ids()) {
+            out->errno = EINVAL;
+            return out->size();
+        }
+        uint32 sub_id = 0;
+        out->errno = drv.subscribe(in->ids, in->num_ids, in->sem, sub_id);
+        out->sub_id = sub_id;
+        return out->size();
+    }
+    case drv_ipc::method::CLK_UNSUBSCRIBE: {
+        drv_ipc::clk_unsubscribe_args *in
+            = reinterpret_cast<drv_ipc::clk_unsubscribe_args *>(msg);
+        drv_ipc::clk_unsubscribe_ret *out = reinterpret_cast<drv_ipc::clk_unsubscribe_ret *>(msg);
+        out->errno = drv.unsubscribe(in->sub_id);
+        return out->size();
+    }
+    case drv_ipc::method::CLK_CHANGES: {
+        drv_ipc::clk_changes_args *in = reinterpret_cast<drv_ipc::clk_changes_args *>(msg);
+        drv_ipc::clk_changes_ret *out = reinterpret_cast<drv_ipc::clk_changes_ret *>(msg);
+        uint32 sub_id = in->sub_id;
+        out->errno = drv.take_changes(sub_id, out->changed);
+        return out->size();
+    }
+    case drv_ipc::method::CLK_DUMP: {
+        drv_ipc::clk_dump_args *in = reinterpret_cast<drv_ipc::clk_dump_args *>(msg);
+        drv_ipc::clk_dump_ret *out = reinterpret_cast<drv_ipc::clk_dump_ret *>(msg);
+        uint32 cursor = in->cursor;
+        uint32 num_recs;
+        out->cursor = drv.dump(cursor, out->recs, drv_ipc::clk_dump_ret::max_recs(), num_recs);
+        out->num_recs = num_recs;
+        out->errno = ENONE;
+        return out->size();
+    }
+    case drv_ipc::method::STATS_GET: {
+        drv_ipc::stats_get_args *in = reinterpret_cast<drv_ipc::stats_get_args *>(msg);
+        drv_ipc::stats_get_ret *out = reinterpret_cast<drv_ipc::stats_get_ret *>(msg);
+        drv_ipc::stats_set set = in->set;
+        uint32 cursor = in->cursor;
+        uint32 num_recs = 0;
+        uint32 max_recs = static_cast<uint32>(drv_ipc::stats_get_ret::max_recs(set));
+        Errno err = ENONE;
+        if (set == drv_ipc::STATS_METHODS)
+            cursor = portal_stats.get(cursor, out->methods(), max_recs, num_recs);
+        else if (set == drv_ipc::STATS_CLOCKS)
+            cursor = drv.clk_stats(cursor, out->clocks(), max_recs, num_recs);
+        else if (set == drv_ipc::STATS_MMIO)
+            err = drv.mmio_stats(cursor, out->mmio(), max_recs, num_recs);
+        else {
+            out->errno = EINVAL;
+            out->num_recs = 0;
+            return out->size(set);
+        }
+        out->cursor = cursor;
+        out->num_recs = num_recs;
+        out->freq = Timer::freq();
+        out->errno = err;
+        return out->size(set);
+    }
+    case drv_ipc::method::STATS_RESET: {
+        drv_ipc::stats_reset_ret *out = reinterpret_cast<drv_ipc::stats_reset_ret *>(msg);
+        portal_stats.reset();
+        drv.reset_stats();
+        out->errno = ENONE;
+        return out->size();
+    }
     default:
         return 0;
     }
 }
+
+/* runs on the service EC of the caller's CPU, the message is in that EC's UTCB */
+PBL_PORTAL(imx8mq_srv, mword, Mtd, Pbl::Utcb *utcb) {
+    const mword msg = reinterpret_cast<mword>(utcb);
+    uint32 method = reinterpret_cast<drv_ipc::header *>(msg)->id;
+
+    uint64 start = Timer::now();
+    mword words = dispatch(utcb, msg);
+    uint64 ticks = Timer::now() - start;
+
+    // every reply starts with the errno, no reply means an unknown method
+    Errno err = (words != 0) ? reinterpret_cast<drv_ipc::ret *>(msg)->errno : EINVAL;
+    portal_stats.record(method, ticks, err);
+    return words;
+}
 EXPORT_PORTAL(imx8mq_srv, mword);
 
 static constexpr char const *anatop_id = "/anatop@30360000";
@@ -102,19 +278,46 @@ extern "C" mword __ZIP[];
 
 /** Heap layout
  *  ---------------------
- *  |  Service stack    |  (SRV_STACK_SIZE)
+ *  |  Service stack 0  |  (SRV_STACK_SIZE)
+ *  +-------------------+
+ *  |  ...              |
+ *  +-------------------+
+ *  |  Service stack n  |  (SRV_STACK_SIZE), n = SRV_CPUS - 1
+ *  +-------------------+
+ *  |  Worker stack     |  (WORKER_STACK_SIZE)
  *  +-------------------+
  *  |                   |
  */
 
 static inline mword
-srv_stack_va() {
-    return Pbl::heap_start();
+srv_stack_va(Cpu cpu) {
+    return Pbl::heap_start() + cpu * SRV_STACK_SIZE;
 }
 
 static inline mword
-srv_sp_va() {
-    return srv_stack_va() + SRV_STACK_SIZE;
+srv_sp_va(Cpu cpu) {
+    return srv_stack_va(cpu) + SRV_STACK_SIZE;
+}
+
+static inline mword
+worker_sp_va() {
+    return srv_sp_va(SRV_CPUS - 1) + WORKER_STACK_SIZE;
+}
+
+/* runs the async requests, see Imx8mq::run_job */
+static void
+async_worker(void) {
+    Pbl::Utcb *utcb = reinterpret_cast<Pbl::Utcb *>(WORKER_UTCB_BASE);
+
+    for (;;) {
+        Pbl::sm_down(utcb, worker_sm);
+
+        mword sem;
+        while (drv.run_job(sem)) {
+            if (sem != 0) Pbl::sm_up(utcb, sem);
+            notify_changes(utcb);
+        }
+    }
 }
 
 /* 0x1f = all permissions */
@@ -129,18 +332,48 @@ pbl_main(Pbl::Utcb *utcb, Cpu cpu) {
 
     Errno err = drv.probe(utcb, ccm_id, anatop_id);
     ASSERT(err == Errno::ENONE);
+    drv.attach_status(&status_page);
+
+    /* async worker, runs on its own SC so that the portal returns right away */
+    worker_sm = Sel(SELS_BASE++);
+    err = Pbl::create_sm(utcb, worker_sm, 0);
+    ASSERT(err == Errno::ENONE);
+
+    Sel worker_ec(SELS_BASE++);
+    err = Pbl::create_global_ec(utcb, worker_ec, cpu, WORKER_UTCB_BASE, worker_sp_va(),
+                                reinterpret_cast<mword>(async_worker));
+    ASSERT(err == Errno::ENONE);
 
-    Sel ec_sel(SELS_BASE++);
-    Sel evt_base(0);
-    err = Pbl::create_local_ec(utcb, ec_sel, cpu, UTCB_BASE, srv_sp_va(), evt_base);
+    Sel worker_sc(SELS_BASE++);
+    err = Pbl::create_sc(utcb, worker_sc, worker_ec);
     ASSERT(err == Errno::ENONE);
 
     /*Get our UUID from the ZIP*/
     Uuid *my_uuid = reinterpret_cast<Uuid *>(__ZIP);
 
-    /* allow PM connection */
-    Sel pt_sel(SELS_BASE++);
-    err = Pbl::API::srv_create(utcb, ec_sel, *my_uuid, NOVA_PT_CRD(pt_sel), 0,
-                               reinterpret_cast<mword>(PT_ENTRY(imx8mq_srv)));
+    /* clients map the status page read-only through the service */
+    err = Pbl::API::srv_share_mem(utcb, *my_uuid, reinterpret_cast<mword>(&status_page),
+                                  PAGE_SIZE, false);
     ASSERT(err == Errno::ENONE);
+
+    Cpu num_cpus = Pbl::num_cpus();
+    if (num_cpus > SRV_CPUS) num_cpus = SRV_CPUS;
+
+    /*
+     * allow PM connection, one service EC and portal per CPU so callers stay local. The
+     * portals share our UUID, each carries its CPU as the portal argument so the
+     * registrations stay distinct, and the lookup of a client returns the one of its CPU.
+     */
+    for (Cpu c = 0; c < num_cpus; c++) {
+        Sel ec_sel(SELS_BASE++);
+        Sel evt_base(0);
+        err = Pbl::create_local_ec(utcb, ec_sel, c, srv_utcb_va(c), srv_sp_va(c), evt_base);
+        ASSERT(err == Errno::ENONE);
+
+        Sel pt_sel(SELS_BASE++);
+        err = Pbl::API::srv_create(utcb, ec_sel, *my_uuid, NOVA_PT_CRD(pt_sel),
+                                   static_cast<int>(c),
+                                   reinterpret_cast<mword>(PT_ENTRY(imx8mq_srv)));
+        ASSERT(err == Errno::ENONE);
+    }
 }
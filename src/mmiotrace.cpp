@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 BedRock Systems, Inc.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+#include <mmiotrace.hpp>
+
+#if IMX_MMIO_TRACE
+Mmio_trace mmio_trace;
+#endif
+
+/* slot of addr, nullptr once the table is full */
+Mmio_trace::Known *
+Mmio_trace::known(mword addr) {
+    uint16 idx = static_cast<uint16>(((addr >> 2) * 0x9e3779b1u) >> 20) % MAX_REGS;
+    for (uint16 n = 0; n < MAX_REGS; n++, idx = (idx + 1) % MAX_REGS) {
+        Known &k = _regs[idx];
+        if (k.addr == addr) return &k;
+        if (k.addr == 0) {
+            k.addr = addr;
+            k.valid = false;
+            return &k;
+        }
+    }
+    return nullptr;
+}
+
+void
+Mmio_trace::report(drv_ipc::mmio_stats_rec *recs, uint8 kinds) {
+    for (uint8 i = 0; i < kinds; i++) {
+        recs[i] = {};
+        recs[i].kind = i;
+    }
+    for (uint16 i = 0; i < MAX_REGS; i++)
+        _regs[i].addr = 0;
+
+    uint64 first = (_next > MMIO_TRACE_ENTRIES) ? _next - MMIO_TRACE_ENTRIES : 0;
+    for (uint64 i = first; i < _next; i++) {
+        const Entry &e = _entries[i % MMIO_TRACE_ENTRIES];
+        if (e.kind >= kinds) continue;
+
+        drv_ipc::mmio_stats_rec &rec = recs[e.kind];
+        Known *k = known(e.addr);
+        bool valid = (k != nullptr) && k->valid;
+        uint32 val = e.val;
+        if (e.flags & SET) val = valid ? (k->val | e.val) : 0;
+        if (e.flags & CLR) val = valid ? (k->val & ~e.val) : 0;
+        bool same = valid && (k->val == val);
+
+        if (e.flags & WRITE) {
+            rec.writes++;
+            if (e.flags & HW) rec.hw_writes++;
+            if (same) rec.noop_writes++;
+        } else {
+            rec.reads++;
+            if (e.flags & HW) rec.hw_reads++;
+            if (same && !(e.flags & VOLATILE)) {
+                if (k->written)
+                    rec.known_reads++;
+                else
+                    rec.redundant_reads++;
+            }
+        }
+
+        // bits set or cleared in a register of unknown value leave it unknown
+        if ((k != nullptr) && (valid || !(e.flags & (SET | CLR)))) {
+            k->val = val;
+            k->valid = true;
+            k->written = (e.flags & WRITE) != 0;
+        }
+    }
+}